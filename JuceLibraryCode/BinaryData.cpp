@@ -2516,7 +2516,7 @@ static const unsigned char temp_binary_data_11[] =
 "    <Colour name=\"background\" value=\"FF3D3A37\"/>\r\n"
 "  </Styles>\r\n"
 "  <View background-color=\"3D3A37\" resizable=\"0\" border-color=\"3D3A37\"\r\n"
-"        tab-color=\"3D3A37\" lookAndFeel=\"FoleysFinest\" scroll-mode=\"no-scroll\"\r\n"
+"        tab-color=\"3D3A37\" lookAndFeel=\"FoleysFilmstrip\" scroll-mode=\"no-scroll\"\r\n"
 "        resize-corner=\"0\" width=\"960\" height=\"360\">\r\n"
 "    <View background-color=\"CFB896\" border-color=\"CFB896\" flex-direction=\"column\">\r\n"
 "      <View id=\"V_Short\" margin=\"0\" padding=\"0\" border=\"0\" radius=\"0\" border-color=\"CFB896\"\r\n"
@@ -2604,7 +2604,7 @@ const char* getNamedResource (const char* resourceNameUTF8, int& numBytes)
         case 0x9a0c4b89:  numBytes = 4284; return Brand_120px_png;
         case 0x074d78cc:  numBytes = 127981; return LOGO_With_Vase_PNG;
         case 0x488a3151:  numBytes = 18761; return Brand_png;
-        case 0x7ee40a85:  numBytes = 5120; return magic_xml;
+        case 0x7ee40a85:  numBytes = 5123; return magic_xml;
         default: break;
     }
 
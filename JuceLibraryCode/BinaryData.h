@@ -42,7 +42,7 @@ namespace BinaryData
     const int            Brand_pngSize = 18761;
 
     extern const char*   magic_xml;
-    const int            magic_xmlSize = 5120;
+    const int            magic_xmlSize = 5123;
 
     // Number of elements in the namedResourceList and originalFileNames arrays.
     const int namedResourceListSize = 12;
@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+    Created: 16 Mar 2026 9:41:07pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+
+BatchRenderer::BatchRenderer(const OfflineRenderer::Settings& settings, int numWorkers)
+{
+    if (numWorkers <= 0)
+        numWorkers = juce::SystemStats::getNumCpus();
+
+    // Processors are built here on the calling thread, never on the workers.
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        renderers.add(new OfflineRenderer(settings));
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+}
+
+BatchRenderer::~BatchRenderer() = default;
+
+bool BatchRenderer::takeJob(int worker, Job& job)
+{
+    {
+        auto& own = *queues[(size_t)worker];
+        const std::lock_guard<std::mutex> sl(own.lock);
+
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.front();
+            own.jobs.pop_front();
+            return true;
+        }
+    }
+
+    // Own queue empty: steal the smallest remaining job of the fullest queue.
+    for (;;)
+    {
+        WorkQueue* victim = nullptr;
+        size_t victimSize = 0;
+
+        for (auto& queue : queues)
+        {
+            const std::lock_guard<std::mutex> sl(queue->lock);
+            if (queue->jobs.size() > victimSize)
+            {
+                victim = queue.get();
+                victimSize = queue->jobs.size();
+            }
+        }
+
+        if (victim == nullptr)
+            return false;
+
+        const std::lock_guard<std::mutex> sl(victim->lock);
+
+        // Someone else may have emptied it since we looked; pick again.
+        if (!victim->jobs.empty())
+        {
+            job = victim->jobs.back();
+            victim->jobs.pop_back();
+            return true;
+        }
+    }
+}
+
+void BatchRenderer::runWorker(int worker)
+{
+    auto& renderer = *renderers[worker];
+    Job job;
+
+    while (takeJob(worker, job))
+    {
+        JobResult jobResult { job, renderer.renderFile(job.input, job.output), worker };
+
+        if (onFileFinished != nullptr)
+            onFileFinished(jobResult);
+
+        const std::lock_guard<std::mutex> sl(resultsLock);
+
+        if (jobResult.result.wasOk())
+            summary.audioSeconds += (double)jobResult.result.samplesRendered / jobResult.result.sampleRate;
+        else
+            ++summary.numFailed;
+
+        summary.results.add(std::move(jobResult));
+    }
+}
+
+BatchRenderer::Summary BatchRenderer::render(juce::Array<Job> jobs)
+{
+    summary = {};
+    summary.numWorkers = renderers.size();
+
+    for (auto& job : jobs)
+        if (job.size <= 0)
+            job.size = job.input.getSize();
+
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.size > b.size; });
+
+    // Round-robin deal, so every queue starts with one of the largest files.
+    for (int i = 0; i < jobs.size(); ++i)
+        queues[(size_t)(i % renderers.size())]->jobs.push_back(jobs.getReference(i));
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < renderers.size(); ++worker)
+        threads.emplace_back([this, worker] { runWorker(worker); });
+
+    runWorker(0);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    summary.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return summary;
+}
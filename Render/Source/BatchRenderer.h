@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+    Created: 16 Mar 2026 9:41:07pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Renders many files in parallel. Every worker thread owns one
+// OfflineRenderer (and so one processor), which is reused for all the files
+// that worker takes.
+//
+// Files are sorted largest first and dealt round-robin into one queue per
+// worker. A worker takes from the front of its own queue and, once that is
+// empty, steals from the back of the fullest other queue, so the long files
+// start early and the short ones fill the gaps at the end.
+class BatchRenderer
+{
+public:
+    struct Job
+    {
+        juce::File input, output;
+        juce::int64 size = 0;               // bytes, used for the largest-first order
+    };
+
+    struct JobResult
+    {
+        Job job;
+        OfflineRenderer::Result result;
+        int worker = -1;
+    };
+
+    struct Summary
+    {
+        juce::Array<JobResult> results;     // in completion order
+        int    numWorkers = 0;
+        double wallSeconds = 0.0;
+        double audioSeconds = 0.0;          // rendered, tails included
+        int    numFailed = 0;
+
+        double getRealtimeFactor() const noexcept        { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+        double getRealtimeFactorPerCore() const noexcept { return numWorkers > 0 ? getRealtimeFactor() / numWorkers : 0.0; }
+    };
+
+    // numWorkers <= 0 uses one per logical CPU.
+    BatchRenderer(const OfflineRenderer::Settings& settings, int numWorkers);
+    ~BatchRenderer();
+
+    // Called on the worker thread after each file; must be thread safe.
+    std::function<void (const JobResult&)> onFileFinished;
+
+    Summary render(juce::Array<Job> jobs);
+
+    int getNumWorkers() const noexcept { return renderers.size(); }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    bool takeJob(int worker, Job& job);
+    void runWorker(int worker);
+
+    juce::OwnedArray<OfflineRenderer> renderers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+
+    std::mutex resultsLock;
+    Summary summary;
+
+    JUCE_DECLARE_NON_COPYABLE (BatchRenderer)
+};
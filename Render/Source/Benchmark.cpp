@@ -0,0 +1,852 @@
+/*
+  ==============================================================================
+
+    Benchmark.cpp
+    Created: 9 Feb 2026 7:52:18pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "OfflineRenderer.h"
+#include "../../Source/JuceDelayLine.h"
+#include "../../Source/EchoBank.h"
+#include "../../Source/EchoEngine.h"
+#include "../../Source/DspKernels.h"
+
+namespace
+{
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0, 384000.0 };
+    const int    blockSizes[]  = { 16, 64, 256, 1024, 4096 };
+    const int    channelCounts[] = { 1, 2, 4, 8, 16 };
+    const int    voiceCounts[] = { 1, 16, 128, 512 };
+    const int    tapCounts[] = { 1, 3, 8, 16 };
+
+    // Keeps the optimiser from dropping reads whose results are otherwise unused.
+    volatile float benchmarkSink = 0.0f;
+
+    double secondsSince(juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = random.nextFloat() * 0.5f - 0.25f;
+        }
+    }
+}
+
+//==============================================================================
+juce::var Benchmark::makeResult(const juce::String& name, double sampleRate, int blockSize,
+                                int numChannels, juce::int64 numFrames, double seconds)
+{
+    auto* result = new juce::DynamicObject();
+    result->setProperty("name", name);
+    result->setProperty("sampleRate", sampleRate);
+    result->setProperty("blockSize", blockSize);
+    result->setProperty("channels", numChannels);
+    result->setProperty("nsPerSample", seconds * 1.0e9 / ((double)numFrames * numChannels));
+    result->setProperty("realtimeFactor", seconds > 0.0 ? ((double)numFrames / sampleRate) / seconds : 0.0);
+    return juce::var(result);
+}
+
+juce::var Benchmark::benchmarkDelayLine(const Options& options)
+{
+    juce::Array<juce::var> results;
+
+    for (auto sampleRate : sampleRates)
+    {
+        for (auto numChannels : channelCounts)
+        {
+            if (options.quick && (numChannels > 2 || sampleRate > 48000.0))
+                continue;
+
+            JuceDelayLine delayLine;
+            delayLine.prepare(sampleRate, 4000.0f, numChannels);
+
+            const auto numFrames = (juce::int64)(options.secondsPerCase * sampleRate);
+
+            // Same access pattern as processBlock: all channels, then advance once.
+            {
+                const auto start = juce::Time::getHighResolutionTicks();
+                for (juce::int64 i = 0; i < numFrames; ++i)
+                {
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        delayLine.writeSample(ch, (float)(i & 255) * 0.001f);
+
+                    delayLine.advance();
+                }
+                results.add(makeResult("JuceDelayLine::writeSample+advance", sampleRate, 1,
+                                       numChannels, numFrames, secondsSince(start)));
+            }
+
+            for (int interpolate = 0; interpolate < 2; ++interpolate)
+            {
+                float sum = 0.0f;
+                float timeMs = 300.0f;
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                for (juce::int64 i = 0; i < numFrames; ++i)
+                {
+                    // A slowly moving, fractional delay time like a smoothed parameter
+                    timeMs += 0.0003f;
+                    if (timeMs > 1200.0f)
+                        timeMs = 300.0f;
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        sum += delayLine.readSampleMs(ch, timeMs, interpolate != 0);
+
+                    delayLine.advance();
+                }
+                benchmarkSink = sum;
+
+                results.add(makeResult(interpolate != 0 ? "JuceDelayLine::readSampleMs (interpolated)"
+                                                        : "JuceDelayLine::readSampleMs (integer)",
+                                       sampleRate, 1, numChannels, numFrames, secondsSince(start)));
+            }
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkProcessBlock(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x4543484f);
+    juce::MidiBuffer midi;
+
+    for (auto sampleRate : sampleRates)
+    {
+        for (auto blockSize : blockSizes)
+        {
+            for (auto numChannels : channelCounts)
+            {
+                if (options.quick && (numChannels > 2 || blockSize < 64 || sampleRate > 96000.0))
+                    continue;
+
+                for (int automated = 0; automated < 2; ++automated)
+                {
+                    MagicGUIAudioProcessor processor;
+                    processor.setNonRealtime(true);
+                    processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+                    processor.prepareToPlay(sampleRate, blockSize);
+
+                    // Effect on, interpolated reads: the most expensive static setting
+                    OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+                    OfflineRenderer::setParameter(processor, "INTERPOLATION", 1.0f);
+                    OfflineRenderer::setParameter(processor, "TIME_S", 50.0f);
+
+                    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+                    const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+                    double seconds = 0.0;
+
+                    for (juce::int64 b = 0; b < numBlocks; ++b)
+                    {
+                        fillWithNoise(buffer, random);
+
+                        if (automated != 0)
+                        {
+                            // Host-style automation between blocks, not timed.
+                            const float phase = (float)b / 64.0f;
+                            OfflineRenderer::setParameter(processor, "TIME_F", 600.0f + 550.0f * std::sin(phase));
+                            OfflineRenderer::setParameter(processor, "TAP3", 2.0f + std::sin(phase * 1.3f));
+                            OfflineRenderer::setParameter(processor, "FEEDBACK", 0.5f + 0.4f * std::sin(phase * 0.7f));
+                            OfflineRenderer::setParameter(processor, "MIX", 0.5f + 0.5f * std::sin(phase * 0.9f));
+                        }
+
+                        const auto start = juce::Time::getHighResolutionTicks();
+                        processor.processBlock(buffer, midi);
+                        seconds += secondsSince(start);
+                    }
+
+                    results.add(makeResult(automated != 0 ? "processBlock (automated)" : "processBlock (static)",
+                                           sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds));
+                }
+            }
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkEchoBank(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x42414e4b);
+    const double sampleRate = 48000.0;
+    const int blockSize = 256;
+
+    for (auto numVoices : voiceCounts)
+    {
+        if (options.quick && numVoices > 128)
+            continue;
+
+        EchoBank bank;
+        bank.prepare(sampleRate, numVoices);
+        bank.setInterpolation(true);
+
+        // What the bank replaces: one mono EchoEngine per voice
+        juce::OwnedArray<EchoEngine> engines;
+
+        // Every voice a little different, short line on
+        for (int v = 0; v < numVoices; ++v)
+        {
+            EchoBank::VoiceParameters params;
+            params.timeMs_s = 20.0f + 0.1f * (float)v;
+            params.timeMs_f = 250.0f + (float)v;
+            params.feedback = 0.6f;
+            bank.setVoiceParameters(v, params);
+
+            EchoEngine::Parameters engineParams;
+            engineParams.timeMs_s = params.timeMs_s;
+            engineParams.timeMs_f = params.timeMs_f;
+            engineParams.feedback = params.feedback;
+            engineParams.interpolate = true;
+
+            auto* engine = engines.add(new EchoEngine());
+            engine->setParameters(engineParams);
+            engine->prepare(sampleRate, blockSize, 1);
+        }
+
+        juce::AudioBuffer<float> buffer(numVoices, blockSize);
+        const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+        double secondsEngines = 0.0;
+
+        for (int useBank = 0; useBank < 2; ++useBank)
+        {
+            double seconds = 0.0;
+
+            for (juce::int64 b = 0; b < numBlocks; ++b)
+            {
+                fillWithNoise(buffer, random);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                if (useBank != 0)
+                    bank.process(buffer.getArrayOfReadPointers(), buffer.getArrayOfWritePointers(), blockSize);
+                else
+                    for (int v = 0; v < numVoices; ++v)
+                        engines.getUnchecked(v)->process(buffer.getArrayOfWritePointers() + v, 1, blockSize);
+                seconds += secondsSince(start);
+            }
+
+            auto result = makeResult(useBank != 0 ? "EchoBank::process" : "EchoEngine::process (one per voice)",
+                                     sampleRate, blockSize, numVoices, numBlocks * blockSize, seconds);
+
+            if (useBank == 0)
+                secondsEngines = seconds;
+            else if (secondsEngines > 0.0)
+                result.getDynamicObject()->setProperty("relativeToEchoEngines", seconds / secondsEngines);
+
+            results.add(result);
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkEngines(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x46444e31);
+    juce::MidiBuffer midi;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const int numChannels = 2;
+    const char* const names[] = { "processBlock (Triple Tap)", "processBlock (FDN 4)",
+                                  "processBlock (FDN 8)", "processBlock (FDN 16)",
+                                  "processBlock (Multi Tap)", "processBlock (Glitch, dense)" };
+    double secondsTripleTap = 0.0;
+
+    for (int engine = 0; engine < 6; ++engine)
+    {
+        MagicGUIAudioProcessor processor;
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+        OfflineRenderer::setParameter(processor, "INTERPOLATION", 1.0f);
+        OfflineRenderer::setParameter(processor, "ENGINE", (float)engine);
+
+        // About 14 grains sounding at once, close to the pool's 16
+        OfflineRenderer::setParameter(processor, "GRAIN_SIZE", 60.0f);
+        OfflineRenderer::setParameter(processor, "GRAIN_DENSITY", 40.0f);
+        OfflineRenderer::setParameter(processor, "GRAIN_REPEAT", 6.0f);
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+        double seconds = 0.0;
+
+        for (juce::int64 b = 0; b < numBlocks; ++b)
+        {
+            fillWithNoise(buffer, random);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            seconds += secondsSince(start);
+        }
+
+        auto result = makeResult(names[engine], sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds);
+
+        if (engine == 0)
+            secondsTripleTap = seconds;
+        else if (secondsTripleTap > 0.0)
+            result.getDynamicObject()->setProperty("relativeToTripleTap", seconds / secondsTripleTap);
+
+        results.add(result);
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkMultiTap(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x4d544150);
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const auto& kernels = DspKernels::select();
+
+    JuceDelayLine delayLine;
+    delayLine.prepare(sampleRate, 4000.0f, 1);
+    juce::AudioBuffer<float> noise(1, delayLine.getBufferLength());
+    fillWithNoise(noise, random);
+    juce::FloatVectorOperations::copy(delayLine.getWritePointer(0), noise.getReadPointer(0), noise.getNumSamples());
+
+    // A slowly moving base delay, like a smoothed TIME_F
+    juce::AudioBuffer<float> work(3, blockSize);
+    float* baseDelay = work.getWritePointer(0);
+    for (int i = 0; i < blockSize; ++i)
+        baseDelay[i] = delayLine.getDelaySamples(600.0f + 0.01f * (float)i);
+
+    float ratios[16], wetGains[16], sendGains[16];
+    for (int t = 0; t < 16; ++t)
+    {
+        ratios[t] = 0.1875f * (float)(t + 1);
+        wetGains[t] = 0.25f;
+        sendGains[t] = 1.0f / 16.0f;
+    }
+
+    for (int interpolate = 0; interpolate < 2; ++interpolate)
+    {
+        for (auto numTaps : tapCounts)
+        {
+            const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+            float sum = 0.0f;
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (juce::int64 b = 0; b < numBlocks; ++b)
+            {
+                kernels.multiTap(delayLine.getReadPointer(0), delayLine.getBufferLength(), delayLine.getWriteIndex(),
+                                 baseDelay, ratios, wetGains, sendGains, numTaps, delayLine.getMaxDelaySamples(),
+                                 blockSize, interpolate != 0, work.getWritePointer(1), work.getWritePointer(2));
+                sum += work.getSample(1, 0) + work.getSample(2, blockSize - 1);
+                delayLine.advance(blockSize);
+            }
+            const auto seconds = secondsSince(start);
+            benchmarkSink = sum;
+
+            auto result = makeResult(juce::String("DspKernels::multiTap (") + kernels.name
+                                         + (interpolate != 0 ? ", interpolated)" : ", integer)"),
+                                     sampleRate, blockSize, 1, numBlocks * blockSize, seconds);
+            result.getDynamicObject()->setProperty("taps", numTaps);
+            result.getDynamicObject()->setProperty("nsPerTap", seconds * 1.0e9 / ((double)numBlocks * blockSize * numTaps));
+            results.add(result);
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkCrossFeedback(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x58464544);
+    juce::MidiBuffer midi;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const char* const names[] = { "processBlock (cross feedback Off)", "processBlock (cross feedback Ping-Pong)",
+                                  "processBlock (cross feedback Spread)", "processBlock (cross feedback Rotate)" };
+
+    for (auto numChannels : { 2, 8 })
+    {
+        double secondsOff = 0.0;
+
+        for (int pattern = 0; pattern < 4; ++pattern)
+        {
+            MagicGUIAudioProcessor processor;
+            processor.setNonRealtime(true);
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+            OfflineRenderer::setParameter(processor, "FEEDBACK", 0.8f);
+            OfflineRenderer::setParameter(processor, "XFEED", (float)pattern);
+            OfflineRenderer::setParameter(processor, "XFEED_WIDTH", 0.7f);
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+            double seconds = 0.0;
+
+            for (juce::int64 b = 0; b < numBlocks; ++b)
+            {
+                fillWithNoise(buffer, random);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                processor.processBlock(buffer, midi);
+                seconds += secondsSince(start);
+            }
+
+            auto result = makeResult(names[pattern], sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds);
+
+            if (pattern == 0)
+                secondsOff = seconds;
+            else if (secondsOff > 0.0)
+                result.getDynamicObject()->setProperty("overheadPercent", 100.0 * (seconds / secondsOff - 1.0));
+
+            results.add(result);
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkTimeChange(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x54494d45);
+    juce::MidiBuffer midi;
+
+    const double sampleRate = 48000.0;
+    const int numChannels = 2;
+    double secondsGlide = 0.0;
+
+    for (auto blockSize : { 64, 512 })
+    {
+        for (int crossfade = 0; crossfade < 2; ++crossfade)
+        {
+            MagicGUIAudioProcessor processor;
+            processor.setNonRealtime(true);
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+            OfflineRenderer::setParameter(processor, "INTERPOLATION", 1.0f);
+            OfflineRenderer::setParameter(processor, "TIME_MODE", (float)crossfade);
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+            const auto blocksPerJump = juce::jmax((juce::int64)1, (juce::int64)(0.25 * sampleRate) / blockSize);
+            double seconds = 0.0;
+
+            for (juce::int64 b = 0; b < numBlocks; ++b)
+            {
+                fillWithNoise(buffer, random);
+
+                // A new time every quarter second, like stepped automation
+                if (b % blocksPerJump == 0)
+                    OfflineRenderer::setParameter(processor, "TIME_F", 200.0f + 800.0f * random.nextFloat());
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                processor.processBlock(buffer, midi);
+                seconds += secondsSince(start);
+            }
+
+            auto result = makeResult(crossfade != 0 ? "processBlock (time jumps, Crossfade)"
+                                                    : "processBlock (time jumps, interpolated Glide)",
+                                     sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds);
+
+            if (crossfade == 0)
+                secondsGlide = seconds;
+            else if (secondsGlide > 0.0)
+                result.getDynamicObject()->setProperty("relativeToGlide", seconds / secondsGlide);
+
+            results.add(result);
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkDamping(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x44414d50);
+    juce::MidiBuffer midi;
+    double secondsOff = 0.0;
+
+    for (auto blockSize : { 64, 512 })
+    {
+        for (int damped = 0; damped < 2; ++damped)
+        {
+            const double sampleRate = 48000.0;
+            const int numChannels = 2;
+
+            MagicGUIAudioProcessor processor;
+            processor.setNonRealtime(true);
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+            OfflineRenderer::setParameter(processor, "TIME_S", 50.0f);
+            OfflineRenderer::setParameter(processor, "FEEDBACK", 0.9f);
+
+            if (damped != 0)
+            {
+                OfflineRenderer::setParameter(processor, "DAMP_HI", 4000.0f);
+                OfflineRenderer::setParameter(processor, "DAMP_LO", 120.0f);
+            }
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+            double seconds = 0.0;
+
+            for (juce::int64 b = 0; b < numBlocks; ++b)
+            {
+                fillWithNoise(buffer, random);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                processor.processBlock(buffer, midi);
+                seconds += secondsSince(start);
+            }
+
+            auto result = makeResult(damped != 0 ? "processBlock (damped loops)" : "processBlock (undamped loops)",
+                                     sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds);
+
+            // Cost of the damping relative to the same case without it
+            if (damped == 0)
+                secondsOff = seconds;
+            else if (secondsOff > 0.0)
+                result.getDynamicObject()->setProperty("overheadPercent", 100.0 * (seconds / secondsOff - 1.0));
+
+            results.add(result);
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkPrepare(const Options& options)
+{
+    juce::Array<juce::var> results;
+    const int numRepeats = options.quick ? 10 : 100;
+    const int blockSize = 512;
+
+    for (auto numChannels : { 2, 8 })
+    {
+        MagicGUIAudioProcessor processor;
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(numChannels, numChannels, 48000.0, blockSize);
+
+        auto addResult = [&](const juce::String& name, int calls, double seconds)
+        {
+            auto* result = new juce::DynamicObject();
+            result->setProperty("name", name);
+            result->setProperty("channels", numChannels);
+            result->setProperty("calls", calls);
+            result->setProperty("msPerCall", seconds * 1.0e3 / calls);
+            results.add(juce::var(result));
+        };
+
+        auto start = juce::Time::getHighResolutionTicks();
+        processor.prepareToPlay(48000.0, blockSize);
+        addResult("prepareToPlay (first)", 1, secondsSince(start));
+
+        start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < numRepeats; ++i)
+            processor.prepareToPlay(48000.0, blockSize);
+        addResult("prepareToPlay (unchanged)", numRepeats, secondsSince(start));
+
+        // Alternating rates: every call lays the lines out anew
+        start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < numRepeats; ++i)
+            processor.prepareToPlay(i % 2 == 0 ? 44100.0 : 48000.0, blockSize);
+        addResult("prepareToPlay (new sample rate)", numRepeats, secondsSince(start));
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkIdle(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x49444c45);
+    juce::MidiBuffer midi;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 256;
+    const int numChannels = 2;
+
+    MagicGUIAudioProcessor processor;
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+    OfflineRenderer::setParameter(processor, "FEEDBACK", 0.5f);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+    double secondsNoise = 0.0;
+
+    for (int silent = 0; silent < 2; ++silent)
+    {
+        // Untimed: long enough for the tail to die away and the idle state to kick in
+        if (silent != 0)
+        {
+            for (juce::int64 b = 0; b < (juce::int64)(20.0 * sampleRate) / blockSize; ++b)
+            {
+                buffer.clear();
+                processor.processBlock(buffer, midi);
+            }
+        }
+
+        double seconds = 0.0;
+
+        for (juce::int64 b = 0; b < numBlocks; ++b)
+        {
+            if (silent != 0)
+                buffer.clear();
+            else
+                fillWithNoise(buffer, random);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            seconds += secondsSince(start);
+        }
+
+        auto result = makeResult(silent != 0 ? "processBlock (silent, idle)" : "processBlock (noise)",
+                                 sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds);
+
+        if (silent == 0)
+            secondsNoise = seconds;
+        else if (secondsNoise > 0.0)
+            result.getDynamicObject()->setProperty("relativeToNoise", seconds / secondsNoise);
+
+        results.add(result);
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkLoFi(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x4c4f4649);
+    juce::MidiBuffer midi;
+
+    const int blockSize = 512;
+    const int numChannels = 2;
+    const char* const loFiNames[] = { "Off", "1/2", "1/4" };
+
+    for (auto sampleRate : { 48000.0, 192000.0 })
+    {
+        if (options.quick && sampleRate > 48000.0)
+            continue;
+
+        for (auto engine : { 0, 4 })
+        {
+            const juce::String engineName = engine == 0 ? "Triple Tap" : "Multi Tap";
+            double secondsOff = 0.0;
+
+            for (int loFi = 0; loFi < 3; ++loFi)
+            {
+                MagicGUIAudioProcessor processor;
+                processor.setNonRealtime(true);
+                processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+                processor.prepareToPlay(sampleRate, blockSize);
+
+                OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+                OfflineRenderer::setParameter(processor, "INTERPOLATION", 1.0f);
+                OfflineRenderer::setParameter(processor, "ENGINE", (float)engine);
+                OfflineRenderer::setParameter(processor, "LOFI", (float)loFi);
+
+                juce::AudioBuffer<float> buffer(numChannels, blockSize);
+                const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+                double seconds = 0.0;
+
+                for (juce::int64 b = 0; b < numBlocks; ++b)
+                {
+                    fillWithNoise(buffer, random);
+
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    processor.processBlock(buffer, midi);
+                    seconds += secondsSince(start);
+                }
+
+                auto result = makeResult("processBlock (" + engineName + ", LOFI " + loFiNames[loFi] + ")",
+                                         sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds);
+
+                if (loFi == 0)
+                    secondsOff = seconds;
+                else if (secondsOff > 0.0)
+                    result.getDynamicObject()->setProperty("relativeToOff", seconds / secondsOff);
+
+                results.add(result);
+            }
+        }
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkEchoEngine(const Options& options)
+{
+    juce::Array<juce::var> results;
+    juce::Random random(0x45454e47);
+    juce::MidiBuffer midi;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const int numChannels = 2;
+    const int numInstances = options.quick ? 5 : 50;
+
+    // ----- Startup: a new instance, ready to process -----
+    auto addStartup = [&](const juce::String& name, double seconds, double secondsPlugin)
+    {
+        auto* result = new juce::DynamicObject();
+        result->setProperty("name", name);
+        result->setProperty("instances", numInstances);
+        result->setProperty("msPerInstance", seconds * 1.0e3 / numInstances);
+        if (secondsPlugin > 0.0)
+            result->setProperty("relativeToPlugin", seconds / secondsPlugin);
+        results.add(juce::var(result));
+    };
+
+    auto start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < numInstances; ++i)
+    {
+        MagicGUIAudioProcessor processor;
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+    const double secondsPlugin = secondsSince(start);
+    addStartup("MagicGUIAudioProcessor + prepareToPlay", secondsPlugin, 0.0);
+
+    start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < numInstances; ++i)
+    {
+        EchoEngine engine;
+        engine.prepare(sampleRate, blockSize, numChannels);
+    }
+    addStartup("EchoEngine + prepare", secondsSince(start), secondsPlugin);
+
+    // ----- Processing: the same settings through both -----
+    MagicGUIAudioProcessor processor;
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    OfflineRenderer::setParameter(processor, "BYPASS", 1.0f);
+    OfflineRenderer::setParameter(processor, "INTERPOLATION", 1.0f);
+
+    EchoEngine engine;
+    EchoEngine::Parameters parameters;
+    parameters.interpolate = true;
+    engine.setParameters(parameters);
+    engine.prepare(sampleRate, blockSize, numChannels);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.secondsPerCase * sampleRate) / blockSize);
+    double secondsProcessBlock = 0.0;
+
+    for (int bare = 0; bare < 2; ++bare)
+    {
+        double seconds = 0.0;
+
+        for (juce::int64 b = 0; b < numBlocks; ++b)
+        {
+            fillWithNoise(buffer, random);
+
+            const auto blockStart = juce::Time::getHighResolutionTicks();
+            if (bare != 0)
+                engine.process(buffer);
+            else
+                processor.processBlock(buffer, midi);
+            seconds += secondsSince(blockStart);
+        }
+
+        auto result = makeResult(bare != 0 ? "EchoEngine::process" : "processBlock",
+                                 sampleRate, blockSize, numChannels, numBlocks * blockSize, seconds);
+
+        if (bare == 0)
+            secondsProcessBlock = seconds;
+        else if (secondsProcessBlock > 0.0)
+            result.getDynamicObject()->setProperty("relativeToProcessBlock", seconds / secondsProcessBlock);
+
+        results.add(result);
+    }
+
+    return results;
+}
+
+juce::var Benchmark::benchmarkStateRestore(const Options& options)
+{
+    juce::Array<juce::var> results;
+    const int numInstances = options.quick ? 100 : 1000;
+
+    juce::OwnedArray<MagicGUIAudioProcessor> processors;
+    for (int i = 0; i < numInstances; ++i)
+        processors.add(new MagicGUIAudioProcessor());
+
+    auto& source = *processors.getFirst();
+    OfflineRenderer::setParameter(source, "TIME_F", 450.0f);
+    OfflineRenderer::setParameter(source, "FEEDBACK", 0.7f);
+    OfflineRenderer::setParameter(source, "INTERPOLATION", 1.0f);
+
+    juce::MemoryBlock binaryState, legacyState;
+    source.getStateInformation(binaryState);
+    source.foleys::MagicProcessor::getStateInformation(legacyState);
+
+    for (auto* state : { &legacyState, &binaryState })
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (auto* processor : processors)
+            processor->setStateInformation(state->getData(), (int)state->getSize());
+
+        const auto seconds = secondsSince(start);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("name", state == &binaryState ? "setStateInformation (binary)"
+                                                          : "setStateInformation (legacy XML)");
+        result->setProperty("instances", numInstances);
+        result->setProperty("stateBytes", (int)state->getSize());
+        result->setProperty("msTotal", seconds * 1.0e3);
+        result->setProperty("usPerInstance", seconds * 1.0e6 / numInstances);
+        results.add(juce::var(result));
+    }
+
+    return results;
+}
+
+juce::var Benchmark::runAll(const Options& options)
+{
+    auto* root = new juce::DynamicObject();
+    root->setProperty("version", ProjectInfo::versionString);
+    root->setProperty("secondsPerCase", options.secondsPerCase);
+    root->setProperty("delayLine", benchmarkDelayLine(options));
+    root->setProperty("processBlock", benchmarkProcessBlock(options));
+    root->setProperty("echoBank", benchmarkEchoBank(options));
+    root->setProperty("engines", benchmarkEngines(options));
+    root->setProperty("multiTap", benchmarkMultiTap(options));
+    root->setProperty("crossFeedback", benchmarkCrossFeedback(options));
+    root->setProperty("timeChange", benchmarkTimeChange(options));
+    root->setProperty("damping", benchmarkDamping(options));
+    root->setProperty("prepare", benchmarkPrepare(options));
+    root->setProperty("idle", benchmarkIdle(options));
+    root->setProperty("loFi", benchmarkLoFi(options));
+    root->setProperty("echoEngine", benchmarkEchoEngine(options));
+    root->setProperty("stateRestore", benchmarkStateRestore(options));
+    return juce::var(root);
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 9 Feb 2026 7:52:18pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Microbenchmarks for JuceDelayLine, the full processBlock, EchoBank and
+// state restore. Results are
+// returned as JSON (ns per channel-sample and realtime factor) so runs from
+// different releases can be diffed.
+class Benchmark
+{
+public:
+    struct Options
+    {
+        double secondsPerCase = 1.0;   // audio seconds processed per case
+        bool   quick = false;          // a reduced sweep for smoke runs
+    };
+
+    static juce::var runAll(const Options& options);
+
+    static juce::var benchmarkDelayLine(const Options& options);
+    static juce::var benchmarkProcessBlock(const Options& options);
+
+    // EchoBank for 1 to 512 voices, relative to one mono EchoEngine per voice.
+    static juce::var benchmarkEchoBank(const Options& options);
+
+    // processBlock with each ENGINE (three taps, FDN 4/8/16, Multi Tap, Glitch),
+    // each also relative to Triple Tap.
+    static juce::var benchmarkEngines(const Options& options);
+
+    // DspKernels::multiTap alone for 1 to 16 taps, with the cost per tap.
+    static juce::var benchmarkMultiTap(const Options& options);
+
+    // processBlock with each cross-feedback pattern, relative to Off, for 2 and 8 channels.
+    static juce::var benchmarkCrossFeedback(const Options& options);
+
+    // processBlock under TIME_F jumps: interpolated Glide vs Crossfade.
+    static juce::var benchmarkTimeChange(const Options& options);
+
+    // processBlock with the feedback damping off and on.
+    static juce::var benchmarkDamping(const Options& options);
+
+    // prepareToPlay on a fresh processor, again with the same settings (the
+    // host's transport start) and at a new sample rate, for 2 and 8 channels.
+    static juce::var benchmarkPrepare(const Options& options);
+
+    // processBlock on silent input once the tail has died away (idle) against
+    // the same processor on noise.
+    static juce::var benchmarkIdle(const Options& options);
+
+    // processBlock for Triple Tap and Multi Tap with LOFI Off, 1/2 and 1/4,
+    // relative to Off, at 48 and 192 kHz.
+    static juce::var benchmarkLoFi(const Options& options);
+
+    // The bare EchoEngine against the plugin around it: construction plus
+    // prepare per instance, and process against processBlock at the same
+    // settings.
+    static juce::var benchmarkEchoEngine(const Options& options);
+
+    // Restores the same state into many processors, legacy XML vs binary.
+    static juce::var benchmarkStateRestore(const Options& options);
+
+    // One case as a JSON object; the shared shape of every result entry.
+    static juce::var makeResult(const juce::String& name, double sampleRate, int blockSize,
+                                int numChannels, juce::int64 numFrames, double seconds);
+};
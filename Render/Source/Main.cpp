@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 2 Feb 2026 8:14:02pm
+    Author:  Xie
+
+    Headless offline renderer: streams audio files through the JECHO
+    processor without an editor, faster than real time.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include "BatchRenderer.h"
+#include "Benchmark.h"
+#include "StressTest.h"
+#include "../../Source/RealtimeSafety.h"
+#include "../../Source/PluginState.h"
+#include <iostream>
+
+namespace
+{
+    OfflineRenderer::Settings parseSettings(const juce::ArgumentList& args)
+    {
+        OfflineRenderer::Settings settings;
+
+        if (args.containsOption("--block"))
+            settings.blockSize = juce::jmax(1, args.getValueForOption("--block").getIntValue());
+
+        if (args.containsOption("--tail"))
+            settings.tailSeconds = juce::jmax(0.0, args.getValueForOption("--tail").getDoubleValue());
+
+        if (args.containsOption("--bits"))
+            settings.bitsPerSample = args.getValueForOption("--bits").getIntValue();
+
+        settings.memoryMapInput = !args.containsOption("--no-mmap");
+
+        if (args.containsOption("--preset"))
+        {
+            const auto presetFile = args.getExistingFileForOption("--preset");
+            if (!presetFile.loadFileAsData(settings.preset))
+                juce::ConsoleApplication::fail("Cannot read preset " + presetFile.getFullPathName());
+        }
+
+        // --set may appear several times: --set TIME_F=450 --set FEEDBACK=0.7
+        for (int i = 0; i < args.size() - 1; ++i)
+        {
+            if (args[i] == "--set")
+            {
+                const auto assignment = args[i + 1].text;
+                if (!assignment.contains("="))
+                    juce::ConsoleApplication::fail("Expected NAME=VALUE after --set, got " + assignment);
+
+                // A typo fails here, once, instead of every file rendering without it
+                const auto paramID = assignment.upToFirstOccurrenceOf("=", false, false).trim();
+                if (!PluginState::getParameterIDs().contains(paramID))
+                    juce::ConsoleApplication::fail("Unknown parameter " + paramID + " in --set " + assignment);
+
+                settings.parameterValues.set(paramID, assignment.fromFirstOccurrenceOf("=", false, false).trim());
+            }
+        }
+
+        return settings;
+    }
+
+    // Plain arguments that are not values of an option are input files.
+    juce::Array<juce::File> getInputFiles(const juce::ArgumentList& args)
+    {
+        static const juce::StringArray optionsWithValue { "-o", "--output", "--block", "--tail",
+                                                          "--bits", "--preset", "--set", "--seconds", "--jobs" };
+        juce::Array<juce::File> inputs;
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+
+            if (optionsWithValue.contains(arg.text))
+            {
+                ++i;
+                continue;
+            }
+
+            if (!arg.isOption())
+                inputs.add(arg.resolveAsExistingFile());
+        }
+
+        return inputs;
+    }
+
+    juce::File getOutputFor(const juce::File& input, const juce::File& outputOption, bool singleInput)
+    {
+        if (singleInput && outputOption != juce::File() && !outputOption.isDirectory())
+            return outputOption;
+
+        const auto folder = outputOption != juce::File() ? outputOption : input.getParentDirectory();
+        return folder.getChildFile(input.getFileNameWithoutExtension() + "_echo.wav");
+    }
+
+    void render(const juce::ArgumentList& args)
+    {
+        const auto settings = parseSettings(args);
+        const auto inputs = getInputFiles(args);
+
+        if (inputs.isEmpty())
+            juce::ConsoleApplication::fail("No input files given");
+
+        juce::File outputOption;
+        if (args.containsOption("-o|--output"))
+            outputOption = args.getFileForOption("-o|--output");
+
+        if (inputs.size() > 1 && outputOption != juce::File())
+            outputOption.createDirectory();
+
+        // One worker per core by default, never more workers than files.
+        int numJobs = args.containsOption("--jobs") ? args.getValueForOption("--jobs").getIntValue() : 0;
+        if (numJobs <= 0)
+            numJobs = juce::SystemStats::getNumCpus();
+
+        // Inputs of the same name from different folders would land on the
+        // same output under -o <dir>; refuse before anything is written.
+        juce::Array<BatchRenderer::Job> jobs;
+        for (auto& input : inputs)
+        {
+            const auto output = getOutputFor(input, outputOption, inputs.size() == 1);
+
+            for (auto& job : jobs)
+                if (job.output == output)
+                    juce::ConsoleApplication::fail(job.input.getFullPathName() + " and " + input.getFullPathName()
+                                                   + " would both be written to " + output.getFullPathName());
+
+            jobs.add({ input, output });
+        }
+
+        BatchRenderer batch(settings, juce::jmin(numJobs, inputs.size()));
+
+        std::mutex consoleLock;
+        batch.onFileFinished = [&consoleLock](const BatchRenderer::JobResult& r)
+        {
+            const std::lock_guard<std::mutex> sl(consoleLock);
+
+            if (r.result.wasOk())
+                std::cout << r.job.input.getFileName() << " -> " << r.job.output.getFullPathName()
+                          << " (" << juce::String(r.result.getRealtimeFactor(), 1) << "x realtime)" << std::endl;
+            else
+                std::cerr << r.result.error << std::endl;
+        };
+
+        const auto summary = batch.render(jobs);
+
+        if (inputs.size() > 1)
+            std::cout << summary.results.size() - summary.numFailed << " files, "
+                      << juce::String(summary.audioSeconds, 1) << " s of audio in "
+                      << juce::String(summary.wallSeconds, 2) << " s on " << summary.numWorkers << " threads: "
+                      << juce::String(summary.getRealtimeFactor(), 1) << "x realtime, "
+                      << juce::String(summary.getRealtimeFactorPerCore(), 1) << "x per core" << std::endl;
+
+        if (summary.numFailed > 0)
+            juce::ConsoleApplication::fail(juce::String(summary.numFailed) + " file(s) failed");
+    }
+
+    void checkRealtimeSafety(const juce::ArgumentList& args)
+    {
+        const int blockSize = args.containsOption("--block") ? args.getValueForOption("--block").getIntValue() : 512;
+
+        MagicGUIAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, 48000.0, blockSize);
+
+        const auto report = RealtimeSafety::runChecks(processor, 48000.0, blockSize);
+        std::cout << report.toString() << std::endl;
+
+       #if ! JECHO_REALTIME_CHECKS
+        std::cout << "Note: built without JECHO_REALTIME_CHECKS, use the Debug configuration." << std::endl;
+       #endif
+
+        if (!report.passed())
+            juce::ConsoleApplication::fail("processBlock is not real-time safe", 2);
+    }
+
+    void runBenchmarks(const juce::ArgumentList& args)
+    {
+        Benchmark::Options options;
+        options.quick = args.containsOption("--quick");
+
+        if (args.containsOption("--seconds"))
+            options.secondsPerCase = juce::jmax(0.01, args.getValueForOption("--seconds").getDoubleValue());
+
+        const auto json = juce::JSON::toString(Benchmark::runAll(options));
+
+        if (args.containsOption("-o|--output"))
+        {
+            const auto outputFile = args.getFileForOption("-o|--output");
+            if (!outputFile.replaceWithText(json))
+                juce::ConsoleApplication::fail("Cannot write " + outputFile.getFullPathName());
+        }
+        else
+        {
+            std::cout << json << std::endl;
+        }
+    }
+
+    void runStressTest(const juce::ArgumentList& args)
+    {
+        StressTest::Options options;
+        options.allParameters = args.containsOption("--all");
+
+        if (args.containsOption("--seconds"))
+            options.seconds = juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue());
+
+        if (args.containsOption("--max-load"))
+            options.maxLoad = juce::jmax(0.01, args.getValueForOption("--max-load").getDoubleValue());
+
+        // --block 32,64,128
+        if (args.containsOption("--block"))
+        {
+            options.blockSizes.clear();
+
+            for (auto& size : juce::StringArray::fromTokens(args.getValueForOption("--block"), ",", {}))
+                if (size.getIntValue() > 0)
+                    options.blockSizes.add(size.getIntValue());
+        }
+
+        const auto results = StressTest::run(options);
+        std::cout << StressTest::toString(results, options);
+
+        if (args.containsOption("-o|--output"))
+        {
+            const auto outputFile = args.getFileForOption("-o|--output");
+            if (!outputFile.replaceWithText(juce::JSON::toString(StressTest::toJson(results, options))))
+                juce::ConsoleApplication::fail("Cannot write " + outputFile.getFullPathName());
+        }
+
+        for (const auto& result : results)
+            if (!result.passed())
+                juce::ConsoleApplication::fail("processBlock missed the " + juce::String(100.0 * options.maxLoad, 0)
+                                               + "% deadline limit", 3);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage: JECHORender [options] <input> [<input>...]", false);
+
+    app.addDefaultCommand({ "",
+                            "[-o <file|dir>] [--preset <file>] [--set NAME=VALUE]... [--tail <seconds>] [--block <samples>] [--bits <n>] [--jobs <n>] [--no-mmap] <input>...",
+                            "Renders the inputs through the echo and writes WAV files",
+                            "The effect is switched on (BYPASS=1), then --preset loads a state saved by the plugin\n"
+                            "and --set values are applied after it, e.g. --set TIME_F=450 --set INTERPOLATION=on,\n"
+                            "with parameter IDs and plain values. An unknown ID is an error.\n"
+                            "--tail adds that many seconds after the input so the repeats can ring out (default 2).\n"
+                            "Without -o each output is written next to its input as <name>_echo.wav.\n"
+                            "Two inputs that would get the same output (same name, -o <dir>) are an error.\n"
+                            "Several inputs are rendered in parallel, largest first, on --jobs threads (default: all cores).\n"
+                            "WAV and AIFF inputs are memory-mapped a window at a time; --no-mmap reads them normally.",
+                            render });
+
+    app.addCommand({ "--rt-check",
+                     "--rt-check [--block <samples>]",
+                     "Runs the real-time safety checker over processBlock",
+                     "Sweeps every parameter, toggles bypass/interpolation and repeats prepareToPlay,\n"
+                     "then sends random blocks of 1-16384 samples prepared small and large while TIME_S\n"
+                     "switches the short line off and on, failing if processBlock allocates, frees or\n"
+                     "locks. Needs JECHO_REALTIME_CHECKS=1.",
+                     checkRealtimeSafety });
+
+    app.addCommand({ "--bench",
+                     "--bench [--quick] [--seconds <s>] [-o <file.json>]",
+                     "Benchmarks JuceDelayLine, processBlock, EchoBank and state restore, printing JSON",
+                     "Sweeps sample rates 44.1-384 kHz, block sizes 16-4096 and 1-16 channels, with\n"
+                     "static and automated parameters. Reports ns per channel-sample and realtime factor,\n"
+                     "and the time to restore 1000 instances from the legacy and the binary state.",
+                     runBenchmarks });
+
+    app.addCommand({ "--stress",
+                     "--stress [--block 32,64] [--seconds <s>] [--max-load <fraction>] [--all] [-o <file.json>]",
+                     "Times every processBlock under random automation and reports the worst cases",
+                     "Automates TIME_S, TIME_F, FEEDBACK, MIX, GAIN, BYPASS, INTERPOLATION and TAP3 at random\n"
+                     "between blocks (rapid toggles, TIME_F/TAP3 jumps between their extremes), --all also the\n"
+                     "engine and the rest. Reports p50, p99, p99.9 and max of the block time against the block\n"
+                     "deadline and fails if any block takes longer than --max-load of it (default 1.0).",
+                     runStressTest });
+
+    return app.findAndRunCommand(argc, argv);
+}
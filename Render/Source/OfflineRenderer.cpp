@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 2 Feb 2026 8:15:27pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+
+OfflineRenderer::OfflineRenderer(const Settings& settingsToUse)
+    : settings(settingsToUse)
+{
+    jassert(settings.blockSize > 0);
+
+    formatManager.registerBasicFormats();
+    processor.setNonRealtime(true);
+    applySettings();
+
+    writerThread.startThread();
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+    writerThread.stopThread(2000);
+}
+
+bool OfflineRenderer::setParameter(juce::AudioProcessor& processor, const juce::String& paramID, float plainValue)
+{
+    for (auto* param : processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+        {
+            if (ranged->paramID == paramID)
+            {
+                ranged->setValueNotifyingHost(ranged->convertTo0to1(plainValue));
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+std::unique_ptr<juce::AudioFormatReader> OfflineRenderer::createReaderFor(const juce::File& input)
+{
+    if (settings.memoryMapInput)
+    {
+        if (auto* format = formatManager.findFormatForFileExtension(input.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(input));
+
+            // Only the header is parsed here; sample data is mapped window by window in renderFile.
+            if (mapped != nullptr && mapped->lengthInSamples > 0)
+                return mapped;
+        }
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(input));
+}
+
+void OfflineRenderer::applySettings()
+{
+    // BYPASS is 1 for "effect on" and defaults to off; a render is for the echo
+    setParameter(processor, "BYPASS", 1.0f);
+
+    if (settings.preset.getSize() > 0)
+        processor.setStateInformation(settings.preset.getData(), (int)settings.preset.getSize());
+
+    for (auto& paramID : settings.parameterValues.getAllKeys())
+    {
+        const auto text = settings.parameterValues[paramID].trim();
+        const float value = text.equalsIgnoreCase("true") || text.equalsIgnoreCase("on") ? 1.0f
+                          : text.equalsIgnoreCase("false") || text.equalsIgnoreCase("off") ? 0.0f
+                          : text.getFloatValue();
+
+        if (!setParameter(processor, paramID, value) && settingsError.isEmpty())
+            settingsError = "Unknown parameter " + paramID;
+    }
+}
+
+OfflineRenderer::Result OfflineRenderer::renderFile(const juce::File& input, const juce::File& output)
+{
+    Result result;
+
+    // Rendering without a setting that was asked for would go unnoticed
+    if (settingsError.isNotEmpty())
+    {
+        result.error = settingsError;
+        return result;
+    }
+
+    auto reader = createReaderFor(input);
+    auto* mapped = dynamic_cast<juce::MemoryMappedAudioFormatReader*>(reader.get());
+
+    if (reader == nullptr)
+    {
+        result.error = "Cannot read " + input.getFullPathName();
+        return result;
+    }
+
+    const int numChannels = (int)reader->numChannels;
+    const double sampleRate = reader->sampleRate;
+    const int bits = settings.bitsPerSample > 0 ? settings.bitsPerSample
+                   : reader->usesFloatingPointData ? 24 : (int)reader->bitsPerSample;
+
+    output.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream = std::make_unique<juce::FileOutputStream>(output);
+
+    juce::WavAudioFormat wav;
+    auto writer = wav.createWriterFor(stream, juce::AudioFormatWriterOptions{}
+                                                  .withSampleRate(sampleRate)
+                                                  .withNumChannels(numChannels)
+                                                  .withBitsPerSample(bits));
+
+    if (writer == nullptr)
+    {
+        result.error = "Cannot write " + output.getFullPathName();
+        return result;
+    }
+
+    // The FIFO takes the writer; deleting it below flushes what is left.
+    auto threadedWriter = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(writer.release(), writerThread,
+                                                                                   settings.blockSize * blocksInWriteFifo);
+
+    // Same channel count in and out; the echo is processed per channel.
+    processor.enableAllBuses();
+    processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, settings.blockSize);
+    processor.prepareToPlay(sampleRate, settings.blockSize);
+
+    buffer.setSize(numChannels, settings.blockSize, false, false, true);
+
+    const juce::int64 inputLength = reader->lengthInSamples;
+    const juce::int64 totalLength = inputLength + (juce::int64)(settings.tailSeconds * sampleRate);
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (juce::int64 pos = 0; pos < totalLength; pos += settings.blockSize)
+    {
+        const int numSamples = (int)juce::jmin((juce::int64)settings.blockSize, totalLength - pos);
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+        // Slide the mapped window on when this block leaves it. Reads are
+        // plain copies out of the page cache, so only the window is resident.
+        if (mapped != nullptr && pos < inputLength
+             && !mapped->getMappedSection().contains({ pos, juce::jmin(pos + numSamples, inputLength) }))
+        {
+            const auto windowEnd = juce::jmin(pos + (juce::int64)settings.blockSize * blocksPerMappedWindow, inputLength);
+
+            if (!mapped->mapSectionOfFile({ pos, windowEnd }))
+            {
+                result.error = "Cannot map " + input.getFullPathName();
+                return result;
+            }
+        }
+
+        // Past the end of the input the reader pads with silence: that is the tail.
+        reader->read(&block, 0, numSamples, pos, true, true);
+
+        processor.processBlock(block, midi);
+
+        // Only blocks when the disk falls more than the FIFO behind.
+        while (!threadedWriter->write(block.getArrayOfReadPointers(), numSamples))
+            juce::Thread::sleep(1);
+    }
+
+    threadedWriter.reset();
+    processor.releaseResources();
+
+    result.secondsTaken = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    result.samplesRendered = totalLength;
+    result.sampleRate = sampleRate;
+    return result;
+}
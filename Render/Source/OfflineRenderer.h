@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 2 Feb 2026 8:15:27pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+// Streams audio files through a MagicGUIAudioProcessor without an editor,
+// as fast as the machine allows. One renderer owns one processor, so it must
+// only be used from one thread at a time.
+//
+// Memory use does not depend on the file length: WAV and AIFF input is read
+// through a sliding memory-mapped window (other formats through a normal
+// reader), and output goes through a FIFO drained by a background thread, so
+// the disk write of one block overlaps the processing of the next.
+class OfflineRenderer
+{
+public:
+    struct Settings
+    {
+        int    blockSize = 8192;
+        double tailSeconds = 2.0;
+        int    bitsPerSample = 0;              // 0 = same as the input (24 for float input)
+        bool   memoryMapInput = true;          // false always uses a normal reader
+
+        juce::MemoryBlock preset;              // state saved by the plugin, applied after BYPASS=1 (effect on)
+        juce::StringPairArray parameterValues; // paramID -> plain value, applied after the preset
+    };
+
+    struct Result
+    {
+        juce::String error;                    // empty on success
+        juce::int64  samplesRendered = 0;
+        double       sampleRate = 0.0;
+        double       secondsTaken = 0.0;
+
+        bool   wasOk() const noexcept { return error.isEmpty(); }
+        double getRealtimeFactor() const noexcept
+        {
+            return secondsTaken > 0.0 ? ((double)samplesRendered / sampleRate) / secondsTaken : 0.0;
+        }
+    };
+
+    explicit OfflineRenderer(const Settings& settingsToUse);
+    ~OfflineRenderer();
+
+    // Fails without rendering if a parameter in the settings doesn't exist.
+    Result renderFile(const juce::File& input, const juce::File& output);
+
+    MagicGUIAudioProcessor& getProcessor() noexcept { return processor; }
+
+    // Sets a parameter by ID from its plain (unnormalised) value.
+    static bool setParameter(juce::AudioProcessor& processor, const juce::String& paramID, float plainValue);
+
+private:
+    void applySettings();
+    std::unique_ptr<juce::AudioFormatReader> createReaderFor(const juce::File& input);
+
+    static constexpr int blocksPerMappedWindow = 64;
+    static constexpr int blocksInWriteFifo = 4;
+
+    Settings settings;
+    juce::String settingsError;            // e.g. an unknown --set ID
+    MagicGUIAudioProcessor processor;
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread writerThread { "JECHORender writer" };
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+
+    JUCE_DECLARE_NON_COPYABLE (OfflineRenderer)
+};
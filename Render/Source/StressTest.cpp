@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+    StressTest.cpp
+    Created: 28 Apr 2026 8:35:14pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "StressTest.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    const juce::StringArray toggledIDs { "BYPASS", "INTERPOLATION" };
+    const juce::StringArray jumpingIDs { "TIME_F", "TAP3" };
+    const juce::StringArray wanderingIDs { "TIME_S", "FEEDBACK", "MIX", "GAIN" };
+
+    // Chances per block
+    const float toggleChance = 0.1f;
+    const float jumpChance = 0.05f;
+    const float wanderChance = 0.02f;
+    const float otherChance = 0.005f;
+
+    const double warmUpSeconds = 1.0;
+
+    struct AutomatedParameter
+    {
+        juce::AudioProcessorParameter* parameter = nullptr;
+        enum { toggled, jumping, wandering, other } kind = other;
+    };
+
+    juce::Array<AutomatedParameter> findParameters(juce::AudioProcessor& processor, bool allParameters)
+    {
+        juce::Array<AutomatedParameter> automated;
+
+        for (auto* parameter : processor.getParameters())
+        {
+            auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter);
+            if (withID == nullptr)
+                continue;
+
+            AutomatedParameter entry;
+            entry.parameter = parameter;
+
+            if (toggledIDs.contains(withID->paramID))
+                entry.kind = AutomatedParameter::toggled;
+            else if (jumpingIDs.contains(withID->paramID))
+                entry.kind = AutomatedParameter::jumping;
+            else if (wanderingIDs.contains(withID->paramID))
+                entry.kind = AutomatedParameter::wandering;
+            else if (!allParameters)
+                continue;
+
+            automated.add(entry);
+        }
+
+        return automated;
+    }
+
+    // Between blocks, outside the timing, like host automation.
+    void automate(const juce::Array<AutomatedParameter>& parameters, juce::Random& random)
+    {
+        for (const auto& entry : parameters)
+        {
+            auto* parameter = entry.parameter;
+            const float chance = random.nextFloat();
+
+            switch (entry.kind)
+            {
+                case AutomatedParameter::toggled:
+                    if (chance < toggleChance)
+                        parameter->setValueNotifyingHost(parameter->getValue() < 0.5f ? 1.0f : 0.0f);
+                    break;
+
+                case AutomatedParameter::jumping:
+                    // To either end of the range, or anywhere in between
+                    if (chance < jumpChance)
+                        parameter->setValueNotifyingHost(random.nextBool() ? 1.0f : 0.0f);
+                    else if (chance < 2.0f * jumpChance)
+                        parameter->setValueNotifyingHost(random.nextFloat());
+                    break;
+
+                case AutomatedParameter::wandering:
+                    if (chance < wanderChance)
+                        parameter->setValueNotifyingHost(random.nextFloat());
+                    break;
+
+                case AutomatedParameter::other:
+                    if (chance < otherChance)
+                        parameter->setValueNotifyingHost(random.nextFloat());
+                    break;
+            }
+        }
+    }
+
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        if (sorted.empty())
+            return 0.0;
+
+        const auto index = (size_t)std::ceil(fraction * (double)sorted.size());
+        return sorted[juce::jlimit((size_t)0, sorted.size() - 1, index > 0 ? index - 1 : 0)];
+    }
+}
+
+//==============================================================================
+juce::Array<StressTest::Result> StressTest::run(const Options& options)
+{
+    juce::Array<Result> results;
+    juce::Random random(0x53545245);
+    juce::MidiBuffer midi;
+
+    const double microsecondsPerTick = 1.0e6 / (double)juce::Time::getHighResolutionTicksPerSecond();
+
+    for (auto blockSize : options.blockSizes)
+    {
+        MagicGUIAudioProcessor processor;
+        processor.setNonRealtime(false);
+        processor.setPlayConfigDetails(options.numChannels, options.numChannels, options.sampleRate, blockSize);
+        processor.prepareToPlay(options.sampleRate, blockSize);
+
+        const auto parameters = findParameters(processor, options.allParameters);
+        juce::AudioBuffer<float> buffer(options.numChannels, blockSize);
+
+        const auto numWarmUpBlocks = (juce::int64)(warmUpSeconds * options.sampleRate) / blockSize;
+        const auto numBlocks = juce::jmax((juce::int64)1, (juce::int64)(options.seconds * options.sampleRate) / blockSize);
+
+        std::vector<double> durations;
+        durations.reserve((size_t)numBlocks);
+
+        Result result;
+        result.blockSize = blockSize;
+        result.numBlocks = numBlocks;
+        result.deadlineUs = 1.0e6 * blockSize / options.sampleRate;
+
+        const double overrunUs = options.maxLoad * result.deadlineUs;
+        juce::int64 blocksToSwitch = 0;
+        bool silent = false;
+
+        for (juce::int64 b = -numWarmUpBlocks; b < numBlocks; ++b)
+        {
+            // Noise and silence in stretches of 0.1 to 2 seconds
+            if (--blocksToSwitch <= 0)
+            {
+                silent = !silent && random.nextFloat() < 0.3f;
+                blocksToSwitch = (juce::int64)((0.1 + 1.9 * random.nextDouble()) * options.sampleRate) / blockSize;
+            }
+
+            for (int ch = 0; ch < options.numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                for (int i = 0; i < blockSize; ++i)
+                    data[i] = silent ? 0.0f : random.nextFloat() * 0.5f - 0.25f;
+            }
+
+            automate(parameters, random);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            const double us = (double)(juce::Time::getHighResolutionTicks() - start) * microsecondsPerTick;
+
+            if (b < 0)
+                continue;
+
+            durations.push_back(us);
+
+            if (us > overrunUs)
+                ++result.numOverruns;
+        }
+
+        std::sort(durations.begin(), durations.end());
+        result.p50Us = percentile(durations, 0.50);
+        result.p99Us = percentile(durations, 0.99);
+        result.p999Us = percentile(durations, 0.999);
+        result.maxUs = durations.empty() ? 0.0 : durations.back();
+        results.add(result);
+    }
+
+    return results;
+}
+
+juce::String StressTest::toString(const juce::Array<Result>& results, const Options& options)
+{
+    juce::String text;
+
+    for (const auto& r : results)
+    {
+        auto load = [&r](double us) { return juce::String(100.0 * us / r.deadlineUs, 1) + "%"; };
+
+        text << "block " << r.blockSize << " (deadline " << juce::String(r.deadlineUs, 1) << " us, "
+             << (int)r.numBlocks << " blocks): p50 " << load(r.p50Us) << ", p99 " << load(r.p99Us)
+             << ", p99.9 " << load(r.p999Us) << ", max " << load(r.maxUs) << " (" << juce::String(r.maxUs, 1) << " us)";
+
+        if (!r.passed())
+            text << ", " << (int)r.numOverruns << " block(s) over " << juce::String(100.0 * options.maxLoad, 0) << "%";
+
+        text << juce::newLine;
+    }
+
+    return text;
+}
+
+juce::var StressTest::toJson(const juce::Array<Result>& results, const Options& options)
+{
+    juce::Array<juce::var> cases;
+
+    for (const auto& r : results)
+    {
+        auto* result = new juce::DynamicObject();
+        result->setProperty("blockSize", r.blockSize);
+        result->setProperty("blocks", r.numBlocks);
+        result->setProperty("deadlineUs", r.deadlineUs);
+        result->setProperty("p50Us", r.p50Us);
+        result->setProperty("p99Us", r.p99Us);
+        result->setProperty("p999Us", r.p999Us);
+        result->setProperty("maxUs", r.maxUs);
+        result->setProperty("overruns", r.numOverruns);
+        cases.add(juce::var(result));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("version", ProjectInfo::versionString);
+    root->setProperty("sampleRate", options.sampleRate);
+    root->setProperty("channels", options.numChannels);
+    root->setProperty("maxLoad", options.maxLoad);
+    root->setProperty("allParameters", options.allParameters);
+    root->setProperty("stress", cases);
+    return juce::var(root);
+}
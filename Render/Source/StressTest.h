@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    StressTest.h
+    Created: 28 Apr 2026 8:35:14pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Worst-case processBlock times under hostile automation, for deadline
+// misses rather than averages.
+//
+// Runs a MagicGUIAudioProcessor at small block sizes while the eight core
+// parameters (TIME_S, TIME_F, FEEDBACK, MIX, GAIN, BYPASS, INTERPOLATION,
+// TAP3) are automated at random between blocks, the way a host would: rapid
+// BYPASS and INTERPOLATION toggles, TIME_F and TAP3 jumping between the ends
+// of their ranges, the rest wandering. The input alternates between noise
+// and silence so the idle state comes and goes too. Every block is timed on
+// its own and compared with its deadline (block length / sample rate).
+class StressTest
+{
+public:
+    struct Options
+    {
+        double seconds = 30.0;          // audio seconds per block size
+        double sampleRate = 48000.0;
+        int    numChannels = 2;
+        double maxLoad = 1.0;           // fail when a block takes longer than this fraction of its deadline
+        juce::Array<int> blockSizes { 32, 64 };
+        bool   allParameters = false;   // also automate ENGINE, the taps, grains, ...
+    };
+
+    struct Result
+    {
+        int         blockSize = 0;
+        juce::int64 numBlocks = 0;
+        double      deadlineUs = 0.0;
+        double      p50Us = 0.0;
+        double      p99Us = 0.0;
+        double      p999Us = 0.0;
+        double      maxUs = 0.0;
+        juce::int64 numOverruns = 0;    // blocks over maxLoad * deadline
+
+        bool passed() const noexcept { return numOverruns == 0; }
+    };
+
+    static juce::Array<Result> run(const Options& options);
+
+    // A summary line per block size.
+    static juce::String toString(const juce::Array<Result>& results, const Options& options);
+
+    // The same as JSON, in the shape of the --bench results.
+    static juce::var toJson(const juce::Array<Result>& results, const Options& options);
+};
@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    CrossFeedbackMatrix.h
+    Created: 20 Apr 2026 10:37:52pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Where each channel's long-line feedback goes: an N x N matrix applied to
+// the feedback of all channels before it is written back, so repeats can
+// bounce between or circle around the channels.
+//
+//   Ping-Pong  every channel feeds the next one (0 -> 1 -> ... -> 0)
+//   Spread     every channel feeds all the others equally
+//   Rotate     channel pairs (0, 1), (2, 3), ... are rotated by up to 90
+//              degrees per repeat; an odd last channel stays where it is
+//
+// Width blends from the identity (0, no cross feedback) to the full pattern
+// (1). Every matrix has a spectral norm of at most 1, so the loop is no
+// less stable than without it. The coefficients are recomputed per chunk;
+// the mixing itself is DspKernels::matrixMix.
+class CrossFeedbackMatrix
+{
+public:
+    enum Pattern
+    {
+        off = 0,
+        pingPong,
+        spread,
+        rotate
+    };
+
+    void prepare(int maxNumChannels)
+    {
+        maxNumChannels = juce::jmax(1, maxNumChannels);
+
+        if (maxNumChannels != maxChannels || coefficients.getData() == nullptr)
+        {
+            maxChannels = maxNumChannels;
+            coefficients.allocate((size_t)(maxChannels * maxChannels), true);
+        }
+
+        numChannels = 1;
+        identity = true;
+    }
+
+    // Once per chunk, for the channels actually processed (at most the prepared number).
+    void update(int pattern, float width, int newNumChannels) noexcept
+    {
+        numChannels = juce::jlimit(1, maxChannels, newNumChannels);
+
+        const int n = numChannels;
+        width = juce::jlimit(0.0f, 1.0f, width);
+        identity = pattern == off || width <= 0.0f || n < 2;
+
+        if (identity)
+            return;
+
+        auto at = [this, n](int row, int column) -> float& { return coefficients[row * n + column]; };
+
+        for (int i = 0; i < n * n; ++i)
+            coefficients[i] = 0.0f;
+
+        if (pattern == pingPong)
+        {
+            for (int c = 0; c < n; ++c)
+            {
+                at(c, c) = 1.0f - width;
+                at(c, (c + n - 1) % n) += width;
+            }
+        }
+        else if (pattern == spread)
+        {
+            const float share = width / (float)(n - 1);
+
+            for (int c = 0; c < n; ++c)
+                for (int j = 0; j < n; ++j)
+                    at(c, j) = (c == j) ? 1.0f - width : share;
+        }
+        else
+        {
+            const float angle = width * juce::MathConstants<float>::halfPi;
+            const float cosine = std::cos(angle), sine = std::sin(angle);
+
+            for (int c = 0; c + 1 < n; c += 2)
+            {
+                at(c, c) = cosine;
+                at(c, c + 1) = -sine;
+                at(c + 1, c) = sine;
+                at(c + 1, c + 1) = cosine;
+            }
+
+            if (n % 2 != 0)
+                at(n - 1, n - 1) = 1.0f;
+        }
+    }
+
+    // Nothing to mix: the feedback stays in its own channel.
+    bool isIdentity() const noexcept { return identity; }
+
+    // Row-major numChannels x numChannels: row c is what channel c receives.
+    const float* getCoefficients() const noexcept { return coefficients.getData(); }
+    int getNumChannels() const noexcept { return numChannels; }
+
+private:
+    juce::HeapBlock<float> coefficients;
+    int maxChannels = 1;
+    int numChannels = 1;
+    bool identity = true;
+};
@@ -0,0 +1,1731 @@
+/*
+  ==============================================================================
+
+    DspKernels.cpp
+    Created: 23 Feb 2026 6:31:50pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "DspKernels.h"
+#include <cmath>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #define JECHO_X86 1
+ #include <immintrin.h>
+#else
+ #define JECHO_X86 0
+#endif
+
+// Lets one translation unit hold every ISA variant: GCC/Clang compile each
+// function for its own target, MSVC accepts the intrinsics anywhere.
+#if defined (__GNUC__) || defined (__clang__)
+ #define JECHO_TARGET(isa) __attribute__((target(isa)))
+#else
+ #define JECHO_TARGET(isa)
+#endif
+
+namespace
+{
+    inline int wrapIndex(int index, int lineLength) noexcept
+    {
+        if (index < 0)
+            return index + lineLength;
+
+        return index >= lineLength ? index - lineLength : index;
+    }
+
+    // Same maths as JuceDelayLine::readSampleMs, with the delay already in samples.
+    inline float readTap(const float* line, int lineLength, int position, float delaySamples, bool interpolate) noexcept
+    {
+        const int delayInt = (int)delaySamples;
+        const int readIndex = wrapIndex(position - delayInt, lineLength);
+
+        if (!interpolate)
+            return line[readIndex];
+
+        const float frac = delaySamples - (float)delayInt;
+        const int readIndex2 = readIndex > 0 ? readIndex - 1 : lineLength - 1;
+
+        const float y0 = line[readIndex];
+        const float y1 = line[readIndex2];
+        return y0 + frac * (y1 - y0);
+    }
+
+    // readTap on voice v of a line interleaved by voice. The reads are never
+    // ahead of the write row, so only the wrap below row 0 is needed.
+    inline float readVoiceTap(const float* line, int lineLength, int stride, int writeIndex,
+                              float delaySamples, int voice, bool interpolate) noexcept
+    {
+        const int delayInt = (int)delaySamples;
+        const int readIndex = wrapIndex(writeIndex - delayInt, lineLength);
+        const float y0 = line[readIndex * stride + voice];
+
+        if (!interpolate)
+            return y0;
+
+        const float frac = delaySamples - (float)delayInt;
+        const int readIndex2 = readIndex > 0 ? readIndex - 1 : lineLength - 1;
+        const float y1 = line[readIndex2 * stride + voice];
+        return y0 + frac * (y1 - y0);
+    }
+
+    inline float writeValue(float input, float delayed, float feedback) noexcept
+    {
+        return juce::jlimit(-1.0f, 1.0f, input + delayed * feedback);
+    }
+
+    // The TPT one-pole step of LoopDamping::tick; s is the integrator state.
+    inline float dampTick(float x, float& s, float G) noexcept
+    {
+        const float v = (x - s) * G;
+        const float y = v + s;
+        s = y + v;
+        return y;
+    }
+
+    inline float outputValue(float dry, float wet, float mix, float gain) noexcept
+    {
+        return std::tanh((dry * (1.0f - mix) + wet * mix) * gain);
+    }
+
+    //==============================================================================
+    // Scalar reference. Also the variant used on non-x86 CPUs.
+    void readTapsScalar(const float* line, int lineLength, int writeIndex,
+                        const float* const* delays, int numTaps, int numSamples,
+                        bool interpolate, float gain, float* out)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readTap(line, lineLength, writeIndex + i, delays[t][i], interpolate);
+
+            out[i] = gain * sum;
+        }
+    }
+
+    void multiTapScalar(const float* line, int lineLength, int writeIndex,
+                        const float* baseDelay, const float* ratios,
+                        const float* wetGains, const float* sendGains, int numTaps,
+                        float maxDelay, int numSamples, bool interpolate,
+                        float* wet, float* send)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float wetSum = 0.0f, sendSum = 0.0f;
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const float y = readTap(line, lineLength, writeIndex + i,
+                                        juce::jmin(baseDelay[i] * ratios[t], maxDelay), interpolate);
+                wetSum += wetGains[t] * y;
+                sendSum += sendGains[t] * y;
+            }
+
+            wet[i] = wetSum;
+            send[i] = sendSum;
+        }
+    }
+
+    void voiceTapsScalar(const float* line, int lineLength, int stride, int writeIndex,
+                         const float* const* delays, int numTaps, int numVoices,
+                         bool interpolate, float gain, float* out)
+    {
+        for (int v = 0; v < numVoices; ++v)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readVoiceTap(line, lineLength, stride, writeIndex, delays[t][v], v, interpolate);
+
+            out[v] = gain * sum;
+        }
+    }
+
+    void dampRowsScalar(float* const* rows, int numRows, int numSamples,
+                        float* lowpassState, float* highpassState,
+                        float gHigh, float gLow, bool highCutOn, bool lowCutOn)
+    {
+        for (int r = 0; r < numRows; ++r)
+        {
+            float* row = rows[r];
+            float lowpass = lowpassState[r];
+            float highpass = highpassState[r];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float x = row[i];
+
+                if (highCutOn)
+                    x = dampTick(x, lowpass, gHigh);
+                if (lowCutOn)
+                    x = x - dampTick(x, highpass, gLow);
+
+                row[i] = x;
+            }
+
+            lowpassState[r] = lowpass;
+            highpassState[r] = highpass;
+        }
+    }
+
+    void grainEnvelopeScalar(const float* window, int firstAge, float windowStep,
+                             float gain, float* envelope, int numSamples)
+    {
+        for (int k = 0; k < numSamples; ++k)
+            envelope[k] = gain * window[(int)((float)(firstAge + k) * windowStep)];
+    }
+
+    void matrixMixScalar(const float* const* in, float* const* out, const float* matrix,
+                         int numChannels, int numSamples)
+    {
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const float* row = matrix + c * numChannels;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float sum = 0.0f;
+                for (int j = 0; j < numChannels; ++j)
+                    sum += row[j] * in[j][i];
+                out[c][i] = sum;
+            }
+        }
+    }
+
+    void writeFeedbackScalar(float* line, int lineLength, int writeIndex,
+                             const float* input, const float* delayed,
+                             float feedback, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            line[wrapIndex(writeIndex + i, lineLength)] = writeValue(input[i], delayed[i], feedback);
+    }
+
+    void outputStageScalar(float* io, const float* wet, float mix, float gain, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            io[i] = outputValue(io[i], wet[i], mix, gain);
+    }
+
+    void softClipScalar(float* io, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            io[i] = std::tanh(io[i]);
+    }
+
+    void butterflyScalar(float* a, float* b, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = a[i], y = b[i];
+            a[i] = x + y;
+            b[i] = x - y;
+        }
+    }
+
+    constexpr int halfBandValues = DspKernels::halfBandStages * 4;
+
+    // The four half-band lanes one step through their allpass chains. As
+    // c * in + (x1 - c * y1) only one multiply-add per allpass is serial.
+    inline void halfBandStepScalar(float (&lanes)[4], const float* coefficients, float* x, float* y) noexcept
+    {
+        for (int k = 0; k < halfBandValues; k += 4)
+        {
+            for (int l = 0; l < 4; ++l)
+            {
+                const float c = coefficients[k + l];
+                const float out = lanes[l] * c + (x[k + l] - y[k + l] * c);
+                x[k + l] = lanes[l];
+                y[k + l] = out;
+                lanes[l] = out;
+            }
+        }
+    }
+
+    void halfBandDecimateScalar(float* state, const float* coefficients, float* a, float* b, int numOut)
+    {
+        // In locals, which the writes through a and b can't alias
+        float x[halfBandValues], y[halfBandValues];
+        std::copy(state, state + halfBandValues, x);
+        std::copy(state + halfBandValues, state + 2 * halfBandValues, y);
+
+        for (int j = 0; j < numOut; ++j)
+        {
+            float lanes[] = { a[2 * j + 1], a[2 * j], b[2 * j + 1], b[2 * j] };
+            halfBandStepScalar(lanes, coefficients, x, y);
+            a[j] = 0.5f * (lanes[0] + lanes[1]);
+            b[j] = 0.5f * (lanes[2] + lanes[3]);
+        }
+
+        std::copy(x, x + halfBandValues, state);
+        std::copy(y, y + halfBandValues, state + halfBandValues);
+    }
+
+    void halfBandInterpolateScalar(float* state, const float* coefficients, const float* inA, const float* inB,
+                                   float* outA, float* outB, int numSamples)
+    {
+        float x[halfBandValues], y[halfBandValues];
+        std::copy(state, state + halfBandValues, x);
+        std::copy(state + halfBandValues, state + 2 * halfBandValues, y);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float lanes[] = { inA[i], inA[i], inB[i], inB[i] };
+            halfBandStepScalar(lanes, coefficients, x, y);
+            outA[2 * i] = lanes[0];
+            outA[2 * i + 1] = lanes[1];
+            outB[2 * i] = lanes[2];
+            outB[2 * i + 1] = lanes[3];
+        }
+
+        std::copy(x, x + halfBandValues, state);
+        std::copy(y, y + halfBandValues, state + halfBandValues);
+    }
+
+    void measureLevelsScalar(const float* data, int numSamples, float& peak, float& sumSquares)
+    {
+        float p = peak, s = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            p = juce::jmax(p, std::abs(data[i]));
+            s += data[i] * data[i];
+        }
+
+        peak = p;
+        sumSquares += s;
+    }
+
+   #if JECHO_X86
+    //==============================================================================
+    // SSE2: 4 lanes. No gather instruction, so the indices are computed in
+    // vectors and the loads done one by one.
+    JECHO_TARGET("sse2")
+    inline __m128 tanhSse2(__m128 x) noexcept
+    {
+        // tanh(x) = (e^2x - 1) / (e^2x + 1); |x| > 9 is +-1 in float anyway
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-9.0f)), _mm_set1_ps(9.0f));
+        const __m128 y = _mm_add_ps(x, x);
+
+        // e^y = 2^n * e^r with r in [-ln2/2, ln2/2] (Cephes expf)
+        const __m128i n = _mm_cvtps_epi32(_mm_mul_ps(y, _mm_set1_ps(1.44269504088896341f)));
+        const __m128  nf = _mm_cvtepi32_ps(n);
+        __m128 r = _mm_sub_ps(y, _mm_mul_ps(nf, _mm_set1_ps(0.693359375f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(nf, _mm_set1_ps(-2.12194440e-4f)));
+
+        __m128 p = _mm_set1_ps(1.9875691500e-4f);
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.3981999507e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894e-2f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459e-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201e-1f));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.0f));
+
+        const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+        const __m128 e = _mm_mul_ps(p, scale);
+        const __m128 one = _mm_set1_ps(1.0f);
+        return _mm_div_ps(_mm_sub_ps(e, one), _mm_add_ps(e, one));
+    }
+
+    JECHO_TARGET("sse2")
+    void readTapsSse2(const float* line, int lineLength, int writeIndex,
+                      const float* const* delays, int numTaps, int numSamples,
+                      bool interpolate, float gain, float* out)
+    {
+        const __m128i length = _mm_set1_epi32(lineLength);
+        const __m128i lastIndex = _mm_set1_epi32(lineLength - 1);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+        alignas(16) int idx[4], idx2[4];
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128i position = _mm_add_epi32(_mm_set1_epi32(writeIndex + i), laneOffsets);
+            __m128 sum = _mm_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m128  d = _mm_loadu_ps(delays[t] + i);
+                const __m128i dInt = _mm_cvttps_epi32(d);
+
+                __m128i index = _mm_sub_epi32(position, dInt);
+                index = _mm_add_epi32(index, _mm_and_si128(_mm_cmplt_epi32(index, zero), length));
+                index = _mm_sub_epi32(index, _mm_and_si128(_mm_cmpgt_epi32(index, lastIndex), length));
+                _mm_store_si128((__m128i*)idx, index);
+
+                const __m128 y0 = _mm_setr_ps(line[idx[0]], line[idx[1]], line[idx[2]], line[idx[3]]);
+
+                if (!interpolate)
+                {
+                    sum = _mm_add_ps(sum, y0);
+                    continue;
+                }
+
+                __m128i index2 = _mm_sub_epi32(index, _mm_set1_epi32(1));
+                index2 = _mm_add_epi32(index2, _mm_and_si128(_mm_cmplt_epi32(index2, zero), length));
+                _mm_store_si128((__m128i*)idx2, index2);
+
+                const __m128 y1 = _mm_setr_ps(line[idx2[0]], line[idx2[1]], line[idx2[2]], line[idx2[3]]);
+                const __m128 frac = _mm_sub_ps(d, _mm_cvtepi32_ps(dInt));
+                sum = _mm_add_ps(sum, _mm_add_ps(y0, _mm_mul_ps(frac, _mm_sub_ps(y1, y0))));
+            }
+
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_set1_ps(gain), sum));
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readTap(line, lineLength, writeIndex + i, delays[t][i], interpolate);
+
+            out[i] = gain * sum;
+        }
+    }
+
+    // The base delay, positions and ring constants are shared by all taps;
+    // each tap costs one multiply, the index math and its gathers.
+    JECHO_TARGET("sse2")
+    void multiTapSse2(const float* line, int lineLength, int writeIndex,
+                      const float* baseDelay, const float* ratios,
+                      const float* wetGains, const float* sendGains, int numTaps,
+                      float maxDelay, int numSamples, bool interpolate,
+                      float* wet, float* send)
+    {
+        const __m128i length = _mm_set1_epi32(lineLength);
+        const __m128i lastIndex = _mm_set1_epi32(lineLength - 1);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128  maxD = _mm_set1_ps(maxDelay);
+        alignas(16) int idx[4], idx2[4];
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128i position = _mm_add_epi32(_mm_set1_epi32(writeIndex + i), laneOffsets);
+            const __m128  base = _mm_loadu_ps(baseDelay + i);
+            __m128 wetSum = _mm_setzero_ps(), sendSum = _mm_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m128  d = _mm_min_ps(_mm_mul_ps(base, _mm_set1_ps(ratios[t])), maxD);
+                const __m128i dInt = _mm_cvttps_epi32(d);
+
+                __m128i index = _mm_sub_epi32(position, dInt);
+                index = _mm_add_epi32(index, _mm_and_si128(_mm_cmplt_epi32(index, zero), length));
+                index = _mm_sub_epi32(index, _mm_and_si128(_mm_cmpgt_epi32(index, lastIndex), length));
+                _mm_store_si128((__m128i*)idx, index);
+
+                __m128 y = _mm_setr_ps(line[idx[0]], line[idx[1]], line[idx[2]], line[idx[3]]);
+
+                if (interpolate)
+                {
+                    __m128i index2 = _mm_sub_epi32(index, _mm_set1_epi32(1));
+                    index2 = _mm_add_epi32(index2, _mm_and_si128(_mm_cmplt_epi32(index2, zero), length));
+                    _mm_store_si128((__m128i*)idx2, index2);
+
+                    const __m128 y1 = _mm_setr_ps(line[idx2[0]], line[idx2[1]], line[idx2[2]], line[idx2[3]]);
+                    const __m128 frac = _mm_sub_ps(d, _mm_cvtepi32_ps(dInt));
+                    y = _mm_add_ps(y, _mm_mul_ps(frac, _mm_sub_ps(y1, y)));
+                }
+
+                wetSum = _mm_add_ps(wetSum, _mm_mul_ps(_mm_set1_ps(wetGains[t]), y));
+                sendSum = _mm_add_ps(sendSum, _mm_mul_ps(_mm_set1_ps(sendGains[t]), y));
+            }
+
+            _mm_storeu_ps(wet + i, wetSum);
+            _mm_storeu_ps(send + i, sendSum);
+        }
+
+        multiTapScalar(line, lineLength, writeIndex + i, baseDelay + i, ratios, wetGains, sendGains,
+                       numTaps, maxDelay, numSamples - i, interpolate, wet + i, send + i);
+    }
+
+    // Lane k is voice v + k: its row times stride plus k. Without SSE4.1's
+    // 32-bit multiply the offsets are worked out per lane with the loads.
+    JECHO_TARGET("sse2")
+    void voiceTapsSse2(const float* line, int lineLength, int stride, int writeIndex,
+                       const float* const* delays, int numTaps, int numVoices,
+                       bool interpolate, float gain, float* out)
+    {
+        const __m128i length = _mm_set1_epi32(lineLength);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i position = _mm_set1_epi32(writeIndex);
+        alignas(16) int idx[4], idx2[4];
+
+        int v = 0;
+        for (; v + 4 <= numVoices; v += 4)
+        {
+            const float* lanes = line + v;
+            __m128 sum = _mm_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m128  d = _mm_loadu_ps(delays[t] + v);
+                const __m128i dInt = _mm_cvttps_epi32(d);
+
+                __m128i index = _mm_sub_epi32(position, dInt);
+                index = _mm_add_epi32(index, _mm_and_si128(_mm_cmplt_epi32(index, zero), length));
+                _mm_store_si128((__m128i*)idx, index);
+
+                const __m128 y0 = _mm_setr_ps(lanes[idx[0] * stride], lanes[idx[1] * stride + 1],
+                                              lanes[idx[2] * stride + 2], lanes[idx[3] * stride + 3]);
+
+                if (!interpolate)
+                {
+                    sum = _mm_add_ps(sum, y0);
+                    continue;
+                }
+
+                __m128i index2 = _mm_sub_epi32(index, _mm_set1_epi32(1));
+                index2 = _mm_add_epi32(index2, _mm_and_si128(_mm_cmplt_epi32(index2, zero), length));
+                _mm_store_si128((__m128i*)idx2, index2);
+
+                const __m128 y1 = _mm_setr_ps(lanes[idx2[0] * stride], lanes[idx2[1] * stride + 1],
+                                              lanes[idx2[2] * stride + 2], lanes[idx2[3] * stride + 3]);
+                const __m128 frac = _mm_sub_ps(d, _mm_cvtepi32_ps(dInt));
+                sum = _mm_add_ps(sum, _mm_add_ps(y0, _mm_mul_ps(frac, _mm_sub_ps(y1, y0))));
+            }
+
+            _mm_storeu_ps(out + v, _mm_mul_ps(_mm_set1_ps(gain), sum));
+        }
+
+        for (; v < numVoices; ++v)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readVoiceTap(line, lineLength, stride, writeIndex, delays[t][v], v, interpolate);
+
+            out[v] = gain * sum;
+        }
+    }
+
+    JECHO_TARGET("sse2")
+    inline __m128 dampStepSse2(__m128 x, __m128& lowpass, __m128& highpass, __m128 gHigh, __m128 gLow,
+                               bool highCutOn, bool lowCutOn) noexcept
+    {
+        if (highCutOn)
+        {
+            const __m128 v = _mm_mul_ps(_mm_sub_ps(x, lowpass), gHigh);
+            x = _mm_add_ps(v, lowpass);
+            lowpass = _mm_add_ps(x, v);
+        }
+
+        if (lowCutOn)
+        {
+            const __m128 v = _mm_mul_ps(_mm_sub_ps(x, highpass), gLow);
+            const __m128 y = _mm_add_ps(v, highpass);
+            highpass = _mm_add_ps(y, v);
+            x = _mm_sub_ps(x, y);
+        }
+
+        return x;
+    }
+
+    // Four rows per pass, one per lane: a 4 x 4 tile of samples is turned so
+    // each register holds one instant of all four, filtered, and turned back.
+    JECHO_TARGET("sse2")
+    void dampRowsSse2(float* const* rows, int numRows, int numSamples,
+                      float* lowpassState, float* highpassState,
+                      float gHigh, float gLow, bool highCutOn, bool lowCutOn)
+    {
+        const __m128 gh = _mm_set1_ps(gHigh);
+        const __m128 gl = _mm_set1_ps(gLow);
+
+        int r = 0;
+        for (; r + 4 <= numRows; r += 4)
+        {
+            float* const row[] = { rows[r], rows[r + 1], rows[r + 2], rows[r + 3] };
+            __m128 lowpass = _mm_loadu_ps(lowpassState + r);
+            __m128 highpass = _mm_loadu_ps(highpassState + r);
+
+            int i = 0;
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                __m128 x0 = _mm_loadu_ps(row[0] + i), x1 = _mm_loadu_ps(row[1] + i);
+                __m128 x2 = _mm_loadu_ps(row[2] + i), x3 = _mm_loadu_ps(row[3] + i);
+                _MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+
+                x0 = dampStepSse2(x0, lowpass, highpass, gh, gl, highCutOn, lowCutOn);
+                x1 = dampStepSse2(x1, lowpass, highpass, gh, gl, highCutOn, lowCutOn);
+                x2 = dampStepSse2(x2, lowpass, highpass, gh, gl, highCutOn, lowCutOn);
+                x3 = dampStepSse2(x3, lowpass, highpass, gh, gl, highCutOn, lowCutOn);
+
+                _MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+                _mm_storeu_ps(row[0] + i, x0);
+                _mm_storeu_ps(row[1] + i, x1);
+                _mm_storeu_ps(row[2] + i, x2);
+                _mm_storeu_ps(row[3] + i, x3);
+            }
+
+            for (; i < numSamples; ++i)
+            {
+                alignas(16) float y[4];
+                const __m128 x = _mm_setr_ps(row[0][i], row[1][i], row[2][i], row[3][i]);
+                _mm_store_ps(y, dampStepSse2(x, lowpass, highpass, gh, gl, highCutOn, lowCutOn));
+
+                for (int k = 0; k < 4; ++k)
+                    row[k][i] = y[k];
+            }
+
+            _mm_storeu_ps(lowpassState + r, lowpass);
+            _mm_storeu_ps(highpassState + r, highpass);
+        }
+
+        dampRowsScalar(rows + r, numRows - r, numSamples, lowpassState + r, highpassState + r,
+                       gHigh, gLow, highCutOn, lowCutOn);
+    }
+
+    // No gather before AVX2: the window entries are loaded one by one.
+    JECHO_TARGET("sse2")
+    void grainEnvelopeSse2(const float* window, int firstAge, float windowStep,
+                           float gain, float* envelope, int numSamples)
+    {
+        const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128  step = _mm_set1_ps(windowStep);
+        const __m128  g = _mm_set1_ps(gain);
+        alignas(16) int idx[4];
+
+        int k = 0;
+        for (; k + 4 <= numSamples; k += 4)
+        {
+            const __m128i age = _mm_add_epi32(_mm_set1_epi32(firstAge + k), laneOffsets);
+            _mm_store_si128((__m128i*)idx, _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(age), step)));
+
+            const __m128 w = _mm_setr_ps(window[idx[0]], window[idx[1]], window[idx[2]], window[idx[3]]);
+            _mm_storeu_ps(envelope + k, _mm_mul_ps(g, w));
+        }
+
+        grainEnvelopeScalar(window, firstAge + k, windowStep, gain, envelope + k, numSamples - k);
+    }
+
+    // A vector of frames at a time; each coefficient is broadcast once per vector.
+    JECHO_TARGET("sse2")
+    void matrixMixSse2(const float* const* in, float* const* out, const float* matrix,
+                       int numChannels, int numSamples)
+    {
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* row = matrix + c * numChannels;
+                __m128 sum = _mm_setzero_ps();
+
+                for (int j = 0; j < numChannels; ++j)
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[j]), _mm_loadu_ps(in[j] + i)));
+
+                _mm_storeu_ps(out[c] + i, sum);
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* row = matrix + c * numChannels;
+                float sum = 0.0f;
+                for (int j = 0; j < numChannels; ++j)
+                    sum += row[j] * in[j][i];
+                out[c][i] = sum;
+            }
+        }
+    }
+
+    JECHO_TARGET("sse2")
+    void writeSegmentSse2(float* dest, const float* input, const float* delayed, float feedback, int numSamples)
+    {
+        const __m128 fb = _mm_set1_ps(feedback);
+        const __m128 lo = _mm_set1_ps(-1.0f);
+        const __m128 hi = _mm_set1_ps(1.0f);
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 x = _mm_add_ps(_mm_loadu_ps(input + i), _mm_mul_ps(_mm_loadu_ps(delayed + i), fb));
+            _mm_storeu_ps(dest + i, _mm_min_ps(_mm_max_ps(x, lo), hi));
+        }
+
+        for (; i < numSamples; ++i)
+            dest[i] = writeValue(input[i], delayed[i], feedback);
+    }
+
+    JECHO_TARGET("sse2")
+    void writeFeedbackSse2(float* line, int lineLength, int writeIndex,
+                           const float* input, const float* delayed,
+                           float feedback, int numSamples)
+    {
+        // At most two contiguous runs: up to the end of the ring, then from its start
+        const int first = juce::jmin(numSamples, lineLength - writeIndex);
+        writeSegmentSse2(line + writeIndex, input, delayed, feedback, first);
+        writeSegmentSse2(line, input + first, delayed + first, feedback, numSamples - first);
+    }
+
+    JECHO_TARGET("sse2")
+    void softClipSse2(float* io, int numSamples)
+    {
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+            _mm_storeu_ps(io + i, tanhSse2(_mm_loadu_ps(io + i)));
+
+        for (; i < numSamples; ++i)
+            io[i] = std::tanh(io[i]);
+    }
+
+    JECHO_TARGET("sse2")
+    void butterflySse2(float* a, float* b, int numSamples)
+    {
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(a + i), y = _mm_loadu_ps(b + i);
+            _mm_storeu_ps(a + i, _mm_add_ps(x, y));
+            _mm_storeu_ps(b + i, _mm_sub_ps(x, y));
+        }
+
+        butterflyScalar(a + i, b + i, numSamples - i);
+    }
+
+    JECHO_TARGET("sse2")
+    void measureLevelsSse2(const float* data, int numSamples, float& peak, float& sumSquares)
+    {
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 p = _mm_setzero_ps(), s = _mm_setzero_ps();
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(data + i);
+            p = _mm_max_ps(p, _mm_and_ps(x, absMask));
+            s = _mm_add_ps(s, _mm_mul_ps(x, x));
+        }
+
+        alignas(16) float lanesP[4], lanesS[4];
+        _mm_store_ps(lanesP, p);
+        _mm_store_ps(lanesS, s);
+
+        float maxP = juce::jmax(juce::jmax(peak, lanesP[0]), juce::jmax(lanesP[1], juce::jmax(lanesP[2], lanesP[3])));
+        float sum = (lanesS[0] + lanesS[1]) + (lanesS[2] + lanesS[3]);
+
+        for (; i < numSamples; ++i)
+        {
+            maxP = juce::jmax(maxP, std::abs(data[i]));
+            sum += data[i] * data[i];
+        }
+
+        peak = maxP;
+        sumSquares += sum;
+    }
+
+    JECHO_TARGET("sse2")
+    void outputStageSse2(float* io, const float* wet, float mix, float gain, int numSamples)
+    {
+        const __m128 dryGain = _mm_set1_ps(1.0f - mix);
+        const __m128 wetGain = _mm_set1_ps(mix);
+        const __m128 outGain = _mm_set1_ps(gain);
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 x = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(io + i), dryGain),
+                                        _mm_mul_ps(_mm_loadu_ps(wet + i), wetGain));
+            _mm_storeu_ps(io + i, tanhSse2(_mm_mul_ps(x, outGain)));
+        }
+
+        for (; i < numSamples; ++i)
+            io[i] = outputValue(io[i], wet[i], mix, gain);
+    }
+
+    // The half-band lanes are exactly one SSE register. The wider ISAs use
+    // these too: a pair of channels has no more than four lanes to fill.
+    JECHO_TARGET("sse2")
+    inline __m128 halfBandStepSse2(__m128 lanes, const __m128* c, __m128* x, __m128* y) noexcept
+    {
+        for (int k = 0; k < DspKernels::halfBandStages; ++k)
+        {
+            const __m128 out = _mm_add_ps(_mm_mul_ps(lanes, c[k]), _mm_sub_ps(x[k], _mm_mul_ps(y[k], c[k])));
+            x[k] = lanes;
+            y[k] = out;
+            lanes = out;
+        }
+
+        return lanes;
+    }
+
+    JECHO_TARGET("sse2")
+    void halfBandDecimateSse2(float* state, const float* coefficients, float* a, float* b, int numOut)
+    {
+        constexpr int n = DspKernels::halfBandStages;
+        __m128 c[n], x[n], y[n];
+
+        for (int k = 0; k < n; ++k)
+        {
+            c[k] = _mm_loadu_ps(coefficients + 4 * k);
+            x[k] = _mm_loadu_ps(state + 4 * k);
+            y[k] = _mm_loadu_ps(state + 4 * (n + k));
+        }
+
+        const __m128 half = _mm_set1_ps(0.5f);
+
+        for (int j = 0; j < numOut; ++j)
+        {
+            const __m128 lanes = halfBandStepSse2(_mm_setr_ps(a[2 * j + 1], a[2 * j], b[2 * j + 1], b[2 * j]), c, x, y);
+
+            // Lane 0: a0 + a1, lane 2: b0 + b1
+            const __m128 sum = _mm_mul_ps(_mm_add_ps(lanes, _mm_shuffle_ps(lanes, lanes, _MM_SHUFFLE(2, 3, 0, 1))), half);
+            a[j] = _mm_cvtss_f32(sum);
+            b[j] = _mm_cvtss_f32(_mm_movehl_ps(sum, sum));
+        }
+
+        for (int k = 0; k < n; ++k)
+        {
+            _mm_storeu_ps(state + 4 * k, x[k]);
+            _mm_storeu_ps(state + 4 * (n + k), y[k]);
+        }
+    }
+
+    JECHO_TARGET("sse2")
+    void halfBandInterpolateSse2(float* state, const float* coefficients, const float* inA, const float* inB,
+                                 float* outA, float* outB, int numSamples)
+    {
+        constexpr int n = DspKernels::halfBandStages;
+        __m128 c[n], x[n], y[n];
+
+        for (int k = 0; k < n; ++k)
+        {
+            c[k] = _mm_loadu_ps(coefficients + 4 * k);
+            x[k] = _mm_loadu_ps(state + 4 * k);
+            y[k] = _mm_loadu_ps(state + 4 * (n + k));
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const __m128 lanes = halfBandStepSse2(_mm_setr_ps(inA[i], inA[i], inB[i], inB[i]), c, x, y);
+
+            // (a0, a1) and (b0, b1) are already in output order
+            _mm_storel_pi((__m64*)(outA + 2 * i), lanes);
+            _mm_storeh_pi((__m64*)(outB + 2 * i), lanes);
+        }
+
+        for (int k = 0; k < n; ++k)
+        {
+            _mm_storeu_ps(state + 4 * k, x[k]);
+            _mm_storeu_ps(state + 4 * (n + k), y[k]);
+        }
+    }
+
+    //==============================================================================
+    // AVX2: 8 lanes with hardware gathers.
+    JECHO_TARGET("avx2")
+    inline __m256 tanhAvx2(__m256 x) noexcept
+    {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-9.0f)), _mm256_set1_ps(9.0f));
+        const __m256 y = _mm256_add_ps(x, x);
+
+        const __m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(y, _mm256_set1_ps(1.44269504088896341f)));
+        const __m256  nf = _mm256_cvtepi32_ps(n);
+        __m256 r = _mm256_sub_ps(y, _mm256_mul_ps(nf, _mm256_set1_ps(0.693359375f)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(nf, _mm256_set1_ps(-2.12194440e-4f)));
+
+        __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.3981999507e-3f));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(8.3334519073e-3f));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(4.1665795894e-2f));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.6666665459e-1f));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(5.0000001201e-1f));
+        p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, r), r), r), _mm256_set1_ps(1.0f));
+
+        const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+        const __m256 e = _mm256_mul_ps(p, scale);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        return _mm256_div_ps(_mm256_sub_ps(e, one), _mm256_add_ps(e, one));
+    }
+
+    JECHO_TARGET("avx2")
+    void readTapsAvx2(const float* line, int lineLength, int writeIndex,
+                      const float* const* delays, int numTaps, int numSamples,
+                      bool interpolate, float gain, float* out)
+    {
+        const __m256i length = _mm256_set1_epi32(lineLength);
+        const __m256i lastIndex = _mm256_set1_epi32(lineLength - 1);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256i position = _mm256_add_epi32(_mm256_set1_epi32(writeIndex + i), laneOffsets);
+            __m256 sum = _mm256_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m256  d = _mm256_loadu_ps(delays[t] + i);
+                const __m256i dInt = _mm256_cvttps_epi32(d);
+
+                __m256i index = _mm256_sub_epi32(position, dInt);
+                index = _mm256_add_epi32(index, _mm256_and_si256(_mm256_cmpgt_epi32(zero, index), length));
+                index = _mm256_sub_epi32(index, _mm256_and_si256(_mm256_cmpgt_epi32(index, lastIndex), length));
+
+                const __m256 y0 = _mm256_i32gather_ps(line, index, 4);
+
+                if (!interpolate)
+                {
+                    sum = _mm256_add_ps(sum, y0);
+                    continue;
+                }
+
+                __m256i index2 = _mm256_sub_epi32(index, one);
+                index2 = _mm256_add_epi32(index2, _mm256_and_si256(_mm256_cmpgt_epi32(zero, index2), length));
+
+                const __m256 y1 = _mm256_i32gather_ps(line, index2, 4);
+                const __m256 frac = _mm256_sub_ps(d, _mm256_cvtepi32_ps(dInt));
+                sum = _mm256_add_ps(sum, _mm256_add_ps(y0, _mm256_mul_ps(frac, _mm256_sub_ps(y1, y0))));
+            }
+
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_set1_ps(gain), sum));
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readTap(line, lineLength, writeIndex + i, delays[t][i], interpolate);
+
+            out[i] = gain * sum;
+        }
+    }
+
+    JECHO_TARGET("avx2")
+    void multiTapAvx2(const float* line, int lineLength, int writeIndex,
+                      const float* baseDelay, const float* ratios,
+                      const float* wetGains, const float* sendGains, int numTaps,
+                      float maxDelay, int numSamples, bool interpolate,
+                      float* wet, float* send)
+    {
+        const __m256i length = _mm256_set1_epi32(lineLength);
+        const __m256i lastIndex = _mm256_set1_epi32(lineLength - 1);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256  maxD = _mm256_set1_ps(maxDelay);
+
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256i position = _mm256_add_epi32(_mm256_set1_epi32(writeIndex + i), laneOffsets);
+            const __m256  base = _mm256_loadu_ps(baseDelay + i);
+            __m256 wetSum = _mm256_setzero_ps(), sendSum = _mm256_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m256  d = _mm256_min_ps(_mm256_mul_ps(base, _mm256_set1_ps(ratios[t])), maxD);
+                const __m256i dInt = _mm256_cvttps_epi32(d);
+
+                __m256i index = _mm256_sub_epi32(position, dInt);
+                index = _mm256_add_epi32(index, _mm256_and_si256(_mm256_cmpgt_epi32(zero, index), length));
+                index = _mm256_sub_epi32(index, _mm256_and_si256(_mm256_cmpgt_epi32(index, lastIndex), length));
+
+                __m256 y = _mm256_i32gather_ps(line, index, 4);
+
+                if (interpolate)
+                {
+                    __m256i index2 = _mm256_sub_epi32(index, one);
+                    index2 = _mm256_add_epi32(index2, _mm256_and_si256(_mm256_cmpgt_epi32(zero, index2), length));
+
+                    const __m256 y1 = _mm256_i32gather_ps(line, index2, 4);
+                    const __m256 frac = _mm256_sub_ps(d, _mm256_cvtepi32_ps(dInt));
+                    y = _mm256_add_ps(y, _mm256_mul_ps(frac, _mm256_sub_ps(y1, y)));
+                }
+
+                wetSum = _mm256_add_ps(wetSum, _mm256_mul_ps(_mm256_set1_ps(wetGains[t]), y));
+                sendSum = _mm256_add_ps(sendSum, _mm256_mul_ps(_mm256_set1_ps(sendGains[t]), y));
+            }
+
+            _mm256_storeu_ps(wet + i, wetSum);
+            _mm256_storeu_ps(send + i, sendSum);
+        }
+
+        multiTapScalar(line, lineLength, writeIndex + i, baseDelay + i, ratios, wetGains, sendGains,
+                       numTaps, maxDelay, numSamples - i, interpolate, wet + i, send + i);
+    }
+
+    JECHO_TARGET("avx2")
+    void voiceTapsAvx2(const float* line, int lineLength, int stride, int writeIndex,
+                       const float* const* delays, int numTaps, int numVoices,
+                       bool interpolate, float gain, float* out)
+    {
+        const __m256i length = _mm256_set1_epi32(lineLength);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i position = _mm256_set1_epi32(writeIndex);
+        const __m256i rowStride = _mm256_set1_epi32(stride);
+        const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        int v = 0;
+        for (; v + 8 <= numVoices; v += 8)
+        {
+            const __m256i voices = _mm256_add_epi32(_mm256_set1_epi32(v), laneOffsets);
+            __m256 sum = _mm256_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m256  d = _mm256_loadu_ps(delays[t] + v);
+                const __m256i dInt = _mm256_cvttps_epi32(d);
+
+                __m256i index = _mm256_sub_epi32(position, dInt);
+                index = _mm256_add_epi32(index, _mm256_and_si256(_mm256_cmpgt_epi32(zero, index), length));
+
+                const __m256 y0 = _mm256_i32gather_ps(line, _mm256_add_epi32(_mm256_mullo_epi32(index, rowStride), voices), 4);
+
+                if (!interpolate)
+                {
+                    sum = _mm256_add_ps(sum, y0);
+                    continue;
+                }
+
+                __m256i index2 = _mm256_sub_epi32(index, one);
+                index2 = _mm256_add_epi32(index2, _mm256_and_si256(_mm256_cmpgt_epi32(zero, index2), length));
+
+                const __m256 y1 = _mm256_i32gather_ps(line, _mm256_add_epi32(_mm256_mullo_epi32(index2, rowStride), voices), 4);
+                const __m256 frac = _mm256_sub_ps(d, _mm256_cvtepi32_ps(dInt));
+                sum = _mm256_add_ps(sum, _mm256_add_ps(y0, _mm256_mul_ps(frac, _mm256_sub_ps(y1, y0))));
+            }
+
+            _mm256_storeu_ps(out + v, _mm256_mul_ps(_mm256_set1_ps(gain), sum));
+        }
+
+        for (; v < numVoices; ++v)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readVoiceTap(line, lineLength, stride, writeIndex, delays[t][v], v, interpolate);
+
+            out[v] = gain * sum;
+        }
+    }
+
+    JECHO_TARGET("avx2")
+    inline __m256 dampStepAvx2(__m256 x, __m256& lowpass, __m256& highpass, __m256 gHigh, __m256 gLow,
+                               bool highCutOn, bool lowCutOn) noexcept
+    {
+        if (highCutOn)
+        {
+            const __m256 v = _mm256_mul_ps(_mm256_sub_ps(x, lowpass), gHigh);
+            x = _mm256_add_ps(v, lowpass);
+            lowpass = _mm256_add_ps(x, v);
+        }
+
+        if (lowCutOn)
+        {
+            const __m256 v = _mm256_mul_ps(_mm256_sub_ps(x, highpass), gLow);
+            const __m256 y = _mm256_add_ps(v, highpass);
+            highpass = _mm256_add_ps(y, v);
+            x = _mm256_sub_ps(x, y);
+        }
+
+        return x;
+    }
+
+    // Rows to lanes and back: x[k] lane j <-> x[j] lane k.
+    JECHO_TARGET("avx2")
+    inline void transpose8Avx2(__m256 (&x)[8]) noexcept
+    {
+        __m256 t[8], s[8];
+
+        for (int k = 0; k < 8; k += 2)
+        {
+            t[k] = _mm256_unpacklo_ps(x[k], x[k + 1]);
+            t[k + 1] = _mm256_unpackhi_ps(x[k], x[k + 1]);
+        }
+
+        for (int k = 0; k < 8; k += 4)
+        {
+            s[k] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            s[k + 1] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            s[k + 2] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            s[k + 3] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        for (int k = 0; k < 4; ++k)
+        {
+            x[k] = _mm256_permute2f128_ps(s[k], s[k + 4], 0x20);
+            x[k + 4] = _mm256_permute2f128_ps(s[k], s[k + 4], 0x31);
+        }
+    }
+
+    // Eight rows per pass through 8 x 8 tiles; a remaining group of four
+    // goes to the SSE2 version.
+    JECHO_TARGET("avx2")
+    void dampRowsAvx2(float* const* rows, int numRows, int numSamples,
+                      float* lowpassState, float* highpassState,
+                      float gHigh, float gLow, bool highCutOn, bool lowCutOn)
+    {
+        const __m256 gh = _mm256_set1_ps(gHigh);
+        const __m256 gl = _mm256_set1_ps(gLow);
+
+        int r = 0;
+        for (; r + 8 <= numRows; r += 8)
+        {
+            float* const* row = rows + r;
+            __m256 lowpass = _mm256_loadu_ps(lowpassState + r);
+            __m256 highpass = _mm256_loadu_ps(highpassState + r);
+
+            int i = 0;
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                __m256 x[8];
+
+                for (int k = 0; k < 8; ++k)
+                    x[k] = _mm256_loadu_ps(row[k] + i);
+
+                transpose8Avx2(x);
+
+                for (int k = 0; k < 8; ++k)
+                    x[k] = dampStepAvx2(x[k], lowpass, highpass, gh, gl, highCutOn, lowCutOn);
+
+                transpose8Avx2(x);
+
+                for (int k = 0; k < 8; ++k)
+                    _mm256_storeu_ps(row[k] + i, x[k]);
+            }
+
+            for (; i < numSamples; ++i)
+            {
+                alignas(32) float y[8];
+
+                for (int k = 0; k < 8; ++k)
+                    y[k] = row[k][i];
+
+                _mm256_store_ps(y, dampStepAvx2(_mm256_load_ps(y), lowpass, highpass, gh, gl, highCutOn, lowCutOn));
+
+                for (int k = 0; k < 8; ++k)
+                    row[k][i] = y[k];
+            }
+
+            _mm256_storeu_ps(lowpassState + r, lowpass);
+            _mm256_storeu_ps(highpassState + r, highpass);
+        }
+
+        dampRowsSse2(rows + r, numRows - r, numSamples, lowpassState + r, highpassState + r,
+                     gHigh, gLow, highCutOn, lowCutOn);
+    }
+
+    JECHO_TARGET("avx2")
+    void grainEnvelopeAvx2(const float* window, int firstAge, float windowStep,
+                           float gain, float* envelope, int numSamples)
+    {
+        const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256  step = _mm256_set1_ps(windowStep);
+        const __m256  g = _mm256_set1_ps(gain);
+
+        int k = 0;
+        for (; k + 8 <= numSamples; k += 8)
+        {
+            const __m256i age = _mm256_add_epi32(_mm256_set1_epi32(firstAge + k), laneOffsets);
+            const __m256i index = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(age), step));
+
+            const __m256 w = _mm256_i32gather_ps(window, index, 4);
+            _mm256_storeu_ps(envelope + k, _mm256_mul_ps(g, w));
+        }
+
+        grainEnvelopeScalar(window, firstAge + k, windowStep, gain, envelope + k, numSamples - k);
+    }
+
+    JECHO_TARGET("avx2")
+    void matrixMixAvx2(const float* const* in, float* const* out, const float* matrix,
+                       int numChannels, int numSamples)
+    {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* row = matrix + c * numChannels;
+                __m256 sum = _mm256_setzero_ps();
+
+                for (int j = 0; j < numChannels; ++j)
+                    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(row[j]), _mm256_loadu_ps(in[j] + i)));
+
+                _mm256_storeu_ps(out[c] + i, sum);
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* row = matrix + c * numChannels;
+                float sum = 0.0f;
+                for (int j = 0; j < numChannels; ++j)
+                    sum += row[j] * in[j][i];
+                out[c][i] = sum;
+            }
+        }
+    }
+
+    JECHO_TARGET("avx2")
+    void writeSegmentAvx2(float* dest, const float* input, const float* delayed, float feedback, int numSamples)
+    {
+        const __m256 fb = _mm256_set1_ps(feedback);
+        const __m256 lo = _mm256_set1_ps(-1.0f);
+        const __m256 hi = _mm256_set1_ps(1.0f);
+
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256 x = _mm256_add_ps(_mm256_loadu_ps(input + i), _mm256_mul_ps(_mm256_loadu_ps(delayed + i), fb));
+            _mm256_storeu_ps(dest + i, _mm256_min_ps(_mm256_max_ps(x, lo), hi));
+        }
+
+        for (; i < numSamples; ++i)
+            dest[i] = writeValue(input[i], delayed[i], feedback);
+    }
+
+    JECHO_TARGET("avx2")
+    void writeFeedbackAvx2(float* line, int lineLength, int writeIndex,
+                           const float* input, const float* delayed,
+                           float feedback, int numSamples)
+    {
+        const int first = juce::jmin(numSamples, lineLength - writeIndex);
+        writeSegmentAvx2(line + writeIndex, input, delayed, feedback, first);
+        writeSegmentAvx2(line, input + first, delayed + first, feedback, numSamples - first);
+    }
+
+    JECHO_TARGET("avx2")
+    void softClipAvx2(float* io, int numSamples)
+    {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+            _mm256_storeu_ps(io + i, tanhAvx2(_mm256_loadu_ps(io + i)));
+
+        for (; i < numSamples; ++i)
+            io[i] = std::tanh(io[i]);
+    }
+
+    JECHO_TARGET("avx2")
+    void butterflyAvx2(float* a, float* b, int numSamples)
+    {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(a + i), y = _mm256_loadu_ps(b + i);
+            _mm256_storeu_ps(a + i, _mm256_add_ps(x, y));
+            _mm256_storeu_ps(b + i, _mm256_sub_ps(x, y));
+        }
+
+        butterflyScalar(a + i, b + i, numSamples - i);
+    }
+
+    JECHO_TARGET("avx2")
+    void measureLevelsAvx2(const float* data, int numSamples, float& peak, float& sumSquares)
+    {
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        __m256 p = _mm256_setzero_ps(), s = _mm256_setzero_ps();
+
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(data + i);
+            p = _mm256_max_ps(p, _mm256_and_ps(x, absMask));
+            s = _mm256_add_ps(s, _mm256_mul_ps(x, x));
+        }
+
+        alignas(32) float lanesP[8], lanesS[8];
+        _mm256_store_ps(lanesP, p);
+        _mm256_store_ps(lanesS, s);
+
+        float maxP = peak, sum = 0.0f;
+        for (int k = 0; k < 8; ++k)
+        {
+            maxP = juce::jmax(maxP, lanesP[k]);
+            sum += lanesS[k];
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            maxP = juce::jmax(maxP, std::abs(data[i]));
+            sum += data[i] * data[i];
+        }
+
+        peak = maxP;
+        sumSquares += sum;
+    }
+
+    JECHO_TARGET("avx2")
+    void outputStageAvx2(float* io, const float* wet, float mix, float gain, int numSamples)
+    {
+        const __m256 dryGain = _mm256_set1_ps(1.0f - mix);
+        const __m256 wetGain = _mm256_set1_ps(mix);
+        const __m256 outGain = _mm256_set1_ps(gain);
+
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256 x = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(io + i), dryGain),
+                                           _mm256_mul_ps(_mm256_loadu_ps(wet + i), wetGain));
+            _mm256_storeu_ps(io + i, tanhAvx2(_mm256_mul_ps(x, outGain)));
+        }
+
+        for (; i < numSamples; ++i)
+            io[i] = outputValue(io[i], wet[i], mix, gain);
+    }
+
+    //==============================================================================
+    // AVX-512F: 16 lanes, gathers and mask registers for the ring wrap.
+    JECHO_TARGET("avx512f")
+    inline __m512 tanhAvx512(__m512 x) noexcept
+    {
+        x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(-9.0f)), _mm512_set1_ps(9.0f));
+        const __m512 y = _mm512_add_ps(x, x);
+
+        const __m512i n = _mm512_cvtps_epi32(_mm512_mul_ps(y, _mm512_set1_ps(1.44269504088896341f)));
+        const __m512  nf = _mm512_cvtepi32_ps(n);
+        __m512 r = _mm512_sub_ps(y, _mm512_mul_ps(nf, _mm512_set1_ps(0.693359375f)));
+        r = _mm512_sub_ps(r, _mm512_mul_ps(nf, _mm512_set1_ps(-2.12194440e-4f)));
+
+        __m512 p = _mm512_set1_ps(1.9875691500e-4f);
+        p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(1.3981999507e-3f));
+        p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(8.3334519073e-3f));
+        p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(4.1665795894e-2f));
+        p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(1.6666665459e-1f));
+        p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(5.0000001201e-1f));
+        p = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(p, r), r), r), _mm512_set1_ps(1.0f));
+
+        const __m512 scale = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(127)), 23));
+        const __m512 e = _mm512_mul_ps(p, scale);
+        const __m512 one = _mm512_set1_ps(1.0f);
+        return _mm512_div_ps(_mm512_sub_ps(e, one), _mm512_add_ps(e, one));
+    }
+
+    JECHO_TARGET("avx512f")
+    void readTapsAvx512(const float* line, int lineLength, int writeIndex,
+                        const float* const* delays, int numTaps, int numSamples,
+                        bool interpolate, float gain, float* out)
+    {
+        const __m512i length = _mm512_set1_epi32(lineLength);
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i laneOffsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            const __m512i position = _mm512_add_epi32(_mm512_set1_epi32(writeIndex + i), laneOffsets);
+            __m512 sum = _mm512_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m512  d = _mm512_loadu_ps(delays[t] + i);
+                const __m512i dInt = _mm512_cvttps_epi32(d);
+
+                __m512i index = _mm512_sub_epi32(position, dInt);
+                index = _mm512_mask_add_epi32(index, _mm512_cmplt_epi32_mask(index, zero), index, length);
+                index = _mm512_mask_sub_epi32(index, _mm512_cmpge_epi32_mask(index, length), index, length);
+
+                const __m512 y0 = _mm512_i32gather_ps(index, line, 4);
+
+                if (!interpolate)
+                {
+                    sum = _mm512_add_ps(sum, y0);
+                    continue;
+                }
+
+                __m512i index2 = _mm512_sub_epi32(index, one);
+                index2 = _mm512_mask_add_epi32(index2, _mm512_cmplt_epi32_mask(index2, zero), index2, length);
+
+                const __m512 y1 = _mm512_i32gather_ps(index2, line, 4);
+                const __m512 frac = _mm512_sub_ps(d, _mm512_cvtepi32_ps(dInt));
+                sum = _mm512_add_ps(sum, _mm512_add_ps(y0, _mm512_mul_ps(frac, _mm512_sub_ps(y1, y0))));
+            }
+
+            _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_set1_ps(gain), sum));
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readTap(line, lineLength, writeIndex + i, delays[t][i], interpolate);
+
+            out[i] = gain * sum;
+        }
+    }
+
+    JECHO_TARGET("avx512f")
+    void multiTapAvx512(const float* line, int lineLength, int writeIndex,
+                        const float* baseDelay, const float* ratios,
+                        const float* wetGains, const float* sendGains, int numTaps,
+                        float maxDelay, int numSamples, bool interpolate,
+                        float* wet, float* send)
+    {
+        const __m512i length = _mm512_set1_epi32(lineLength);
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i laneOffsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512  maxD = _mm512_set1_ps(maxDelay);
+
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            const __m512i position = _mm512_add_epi32(_mm512_set1_epi32(writeIndex + i), laneOffsets);
+            const __m512  base = _mm512_loadu_ps(baseDelay + i);
+            __m512 wetSum = _mm512_setzero_ps(), sendSum = _mm512_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m512  d = _mm512_min_ps(_mm512_mul_ps(base, _mm512_set1_ps(ratios[t])), maxD);
+                const __m512i dInt = _mm512_cvttps_epi32(d);
+
+                __m512i index = _mm512_sub_epi32(position, dInt);
+                index = _mm512_mask_add_epi32(index, _mm512_cmplt_epi32_mask(index, zero), index, length);
+                index = _mm512_mask_sub_epi32(index, _mm512_cmpge_epi32_mask(index, length), index, length);
+
+                __m512 y = _mm512_i32gather_ps(index, line, 4);
+
+                if (interpolate)
+                {
+                    __m512i index2 = _mm512_sub_epi32(index, one);
+                    index2 = _mm512_mask_add_epi32(index2, _mm512_cmplt_epi32_mask(index2, zero), index2, length);
+
+                    const __m512 y1 = _mm512_i32gather_ps(index2, line, 4);
+                    const __m512 frac = _mm512_sub_ps(d, _mm512_cvtepi32_ps(dInt));
+                    y = _mm512_add_ps(y, _mm512_mul_ps(frac, _mm512_sub_ps(y1, y)));
+                }
+
+                wetSum = _mm512_fmadd_ps(_mm512_set1_ps(wetGains[t]), y, wetSum);
+                sendSum = _mm512_fmadd_ps(_mm512_set1_ps(sendGains[t]), y, sendSum);
+            }
+
+            _mm512_storeu_ps(wet + i, wetSum);
+            _mm512_storeu_ps(send + i, sendSum);
+        }
+
+        multiTapScalar(line, lineLength, writeIndex + i, baseDelay + i, ratios, wetGains, sendGains,
+                       numTaps, maxDelay, numSamples - i, interpolate, wet + i, send + i);
+    }
+
+    JECHO_TARGET("avx512f")
+    void voiceTapsAvx512(const float* line, int lineLength, int stride, int writeIndex,
+                         const float* const* delays, int numTaps, int numVoices,
+                         bool interpolate, float gain, float* out)
+    {
+        const __m512i length = _mm512_set1_epi32(lineLength);
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i position = _mm512_set1_epi32(writeIndex);
+        const __m512i rowStride = _mm512_set1_epi32(stride);
+        const __m512i laneOffsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+        int v = 0;
+        for (; v + 16 <= numVoices; v += 16)
+        {
+            const __m512i voices = _mm512_add_epi32(_mm512_set1_epi32(v), laneOffsets);
+            __m512 sum = _mm512_setzero_ps();
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const __m512  d = _mm512_loadu_ps(delays[t] + v);
+                const __m512i dInt = _mm512_cvttps_epi32(d);
+
+                __m512i index = _mm512_sub_epi32(position, dInt);
+                index = _mm512_mask_add_epi32(index, _mm512_cmplt_epi32_mask(index, zero), index, length);
+
+                const __m512 y0 = _mm512_i32gather_ps(_mm512_add_epi32(_mm512_mullo_epi32(index, rowStride), voices), line, 4);
+
+                if (!interpolate)
+                {
+                    sum = _mm512_add_ps(sum, y0);
+                    continue;
+                }
+
+                __m512i index2 = _mm512_sub_epi32(index, one);
+                index2 = _mm512_mask_add_epi32(index2, _mm512_cmplt_epi32_mask(index2, zero), index2, length);
+
+                const __m512 y1 = _mm512_i32gather_ps(_mm512_add_epi32(_mm512_mullo_epi32(index2, rowStride), voices), line, 4);
+                const __m512 frac = _mm512_sub_ps(d, _mm512_cvtepi32_ps(dInt));
+                sum = _mm512_add_ps(sum, _mm512_add_ps(y0, _mm512_mul_ps(frac, _mm512_sub_ps(y1, y0))));
+            }
+
+            _mm512_storeu_ps(out + v, _mm512_mul_ps(_mm512_set1_ps(gain), sum));
+        }
+
+        for (; v < numVoices; ++v)
+        {
+            float sum = 0.0f;
+            for (int t = 0; t < numTaps; ++t)
+                sum += readVoiceTap(line, lineLength, stride, writeIndex, delays[t][v], v, interpolate);
+
+            out[v] = gain * sum;
+        }
+    }
+
+    JECHO_TARGET("avx512f")
+    void grainEnvelopeAvx512(const float* window, int firstAge, float windowStep,
+                             float gain, float* envelope, int numSamples)
+    {
+        const __m512i laneOffsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512  step = _mm512_set1_ps(windowStep);
+        const __m512  g = _mm512_set1_ps(gain);
+
+        int k = 0;
+        for (; k + 16 <= numSamples; k += 16)
+        {
+            const __m512i age = _mm512_add_epi32(_mm512_set1_epi32(firstAge + k), laneOffsets);
+            const __m512i index = _mm512_cvttps_epi32(_mm512_mul_ps(_mm512_cvtepi32_ps(age), step));
+
+            const __m512 w = _mm512_i32gather_ps(index, window, 4);
+            _mm512_storeu_ps(envelope + k, _mm512_mul_ps(g, w));
+        }
+
+        grainEnvelopeScalar(window, firstAge + k, windowStep, gain, envelope + k, numSamples - k);
+    }
+
+    JECHO_TARGET("avx512f")
+    void matrixMixAvx512(const float* const* in, float* const* out, const float* matrix,
+                         int numChannels, int numSamples)
+    {
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* row = matrix + c * numChannels;
+                __m512 sum = _mm512_setzero_ps();
+
+                for (int j = 0; j < numChannels; ++j)
+                    sum = _mm512_add_ps(sum, _mm512_mul_ps(_mm512_set1_ps(row[j]), _mm512_loadu_ps(in[j] + i)));
+
+                _mm512_storeu_ps(out[c] + i, sum);
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* row = matrix + c * numChannels;
+                float sum = 0.0f;
+                for (int j = 0; j < numChannels; ++j)
+                    sum += row[j] * in[j][i];
+                out[c][i] = sum;
+            }
+        }
+    }
+
+    JECHO_TARGET("avx512f")
+    void writeSegmentAvx512(float* dest, const float* input, const float* delayed, float feedback, int numSamples)
+    {
+        const __m512 fb = _mm512_set1_ps(feedback);
+        const __m512 lo = _mm512_set1_ps(-1.0f);
+        const __m512 hi = _mm512_set1_ps(1.0f);
+
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            const __m512 x = _mm512_add_ps(_mm512_loadu_ps(input + i), _mm512_mul_ps(_mm512_loadu_ps(delayed + i), fb));
+            _mm512_storeu_ps(dest + i, _mm512_min_ps(_mm512_max_ps(x, lo), hi));
+        }
+
+        for (; i < numSamples; ++i)
+            dest[i] = writeValue(input[i], delayed[i], feedback);
+    }
+
+    JECHO_TARGET("avx512f")
+    void writeFeedbackAvx512(float* line, int lineLength, int writeIndex,
+                             const float* input, const float* delayed,
+                             float feedback, int numSamples)
+    {
+        const int first = juce::jmin(numSamples, lineLength - writeIndex);
+        writeSegmentAvx512(line + writeIndex, input, delayed, feedback, first);
+        writeSegmentAvx512(line, input + first, delayed + first, feedback, numSamples - first);
+    }
+
+    JECHO_TARGET("avx512f")
+    void softClipAvx512(float* io, int numSamples)
+    {
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+            _mm512_storeu_ps(io + i, tanhAvx512(_mm512_loadu_ps(io + i)));
+
+        for (; i < numSamples; ++i)
+            io[i] = std::tanh(io[i]);
+    }
+
+    JECHO_TARGET("avx512f")
+    void butterflyAvx512(float* a, float* b, int numSamples)
+    {
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            const __m512 x = _mm512_loadu_ps(a + i), y = _mm512_loadu_ps(b + i);
+            _mm512_storeu_ps(a + i, _mm512_add_ps(x, y));
+            _mm512_storeu_ps(b + i, _mm512_sub_ps(x, y));
+        }
+
+        butterflyScalar(a + i, b + i, numSamples - i);
+    }
+
+    JECHO_TARGET("avx512f")
+    void measureLevelsAvx512(const float* data, int numSamples, float& peak, float& sumSquares)
+    {
+        __m512 p = _mm512_setzero_ps(), s = _mm512_setzero_ps();
+
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            const __m512 x = _mm512_loadu_ps(data + i);
+            p = _mm512_max_ps(p, _mm512_abs_ps(x));
+            s = _mm512_fmadd_ps(x, x, s);
+        }
+
+        float maxP = juce::jmax(peak, _mm512_reduce_max_ps(p));
+        float sum = _mm512_reduce_add_ps(s);
+
+        for (; i < numSamples; ++i)
+        {
+            maxP = juce::jmax(maxP, std::abs(data[i]));
+            sum += data[i] * data[i];
+        }
+
+        peak = maxP;
+        sumSquares += sum;
+    }
+
+    JECHO_TARGET("avx512f")
+    void outputStageAvx512(float* io, const float* wet, float mix, float gain, int numSamples)
+    {
+        const __m512 dryGain = _mm512_set1_ps(1.0f - mix);
+        const __m512 wetGain = _mm512_set1_ps(mix);
+        const __m512 outGain = _mm512_set1_ps(gain);
+
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            const __m512 x = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(io + i), dryGain),
+                                           _mm512_mul_ps(_mm512_loadu_ps(wet + i), wetGain));
+            _mm512_storeu_ps(io + i, tanhAvx512(_mm512_mul_ps(x, outGain)));
+        }
+
+        for (; i < numSamples; ++i)
+            io[i] = outputValue(io[i], wet[i], mix, gain);
+    }
+   #endif
+
+    //==============================================================================
+    // One entry per line, in DspKernels' member order (C++17 has no designated
+    // initialisers); the comments name the member each pointer fills.
+    const DspKernels scalarKernels
+    {
+        /* readTaps            */ readTapsScalar,
+        /* writeFeedback       */ writeFeedbackScalar,
+        /* outputStage         */ outputStageScalar,
+        /* softClip            */ softClipScalar,
+        /* measureLevels       */ measureLevelsScalar,
+        /* butterfly           */ butterflyScalar,
+        /* multiTap            */ multiTapScalar,
+        /* grainEnvelope       */ grainEnvelopeScalar,
+        /* matrixMix           */ matrixMixScalar,
+        /* halfBandDecimate    */ halfBandDecimateScalar,
+        /* halfBandInterpolate */ halfBandInterpolateScalar,
+        /* voiceTaps           */ voiceTapsScalar,
+        /* dampRows            */ dampRowsScalar,
+        /* name                */ "scalar"
+    };
+
+   #if JECHO_X86
+    const DspKernels sse2Kernels
+    {
+        /* readTaps            */ readTapsSse2,
+        /* writeFeedback       */ writeFeedbackSse2,
+        /* outputStage         */ outputStageSse2,
+        /* softClip            */ softClipSse2,
+        /* measureLevels       */ measureLevelsSse2,
+        /* butterfly           */ butterflySse2,
+        /* multiTap            */ multiTapSse2,
+        /* grainEnvelope       */ grainEnvelopeSse2,
+        /* matrixMix           */ matrixMixSse2,
+        /* halfBandDecimate    */ halfBandDecimateSse2,
+        /* halfBandInterpolate */ halfBandInterpolateSse2,
+        /* voiceTaps           */ voiceTapsSse2,
+        /* dampRows            */ dampRowsSse2,
+        /* name                */ "sse2"
+    };
+
+    const DspKernels avx2Kernels
+    {
+        /* readTaps            */ readTapsAvx2,
+        /* writeFeedback       */ writeFeedbackAvx2,
+        /* outputStage         */ outputStageAvx2,
+        /* softClip            */ softClipAvx2,
+        /* measureLevels       */ measureLevelsAvx2,
+        /* butterfly           */ butterflyAvx2,
+        /* multiTap            */ multiTapAvx2,
+        /* grainEnvelope       */ grainEnvelopeAvx2,
+        /* matrixMix           */ matrixMixAvx2,
+        /* halfBandDecimate    */ halfBandDecimateSse2,
+        /* halfBandInterpolate */ halfBandInterpolateSse2,
+        /* voiceTaps           */ voiceTapsAvx2,
+        /* dampRows            */ dampRowsAvx2,
+        /* name                */ "avx2"
+    };
+
+    const DspKernels avx512Kernels
+    {
+        /* readTaps            */ readTapsAvx512,
+        /* writeFeedback       */ writeFeedbackAvx512,
+        /* outputStage         */ outputStageAvx512,
+        /* softClip            */ softClipAvx512,
+        /* measureLevels       */ measureLevelsAvx512,
+        /* butterfly           */ butterflyAvx512,
+        /* multiTap            */ multiTapAvx512,
+        /* grainEnvelope       */ grainEnvelopeAvx512,
+        /* matrixMix           */ matrixMixAvx512,
+        /* halfBandDecimate    */ halfBandDecimateSse2,
+        /* halfBandInterpolate */ halfBandInterpolateSse2,
+        /* voiceTaps           */ voiceTapsAvx512,
+        /* dampRows            */ dampRowsAvx2,
+        /* name                */ "avx512"
+    };
+   #endif
+}
+
+//==============================================================================
+const DspKernels& DspKernels::scalar()
+{
+    return scalarKernels;
+}
+
+const DspKernels& DspKernels::select()
+{
+    struct Candidate { const DspKernels* kernels; bool supported; };
+
+    // Best first
+    const Candidate candidates[] =
+    {
+       #if JECHO_X86
+        { &avx512Kernels, juce::SystemStats::hasAVX512F() },
+        { &avx2Kernels,   juce::SystemStats::hasAVX2() },
+        { &sse2Kernels,   juce::SystemStats::hasSSE2() },
+       #endif
+        { &scalarKernels, true }
+    };
+
+    const auto forced = juce::SystemStats::getEnvironmentVariable("JECHO_DSP_ISA", {}).trim().toLowerCase();
+
+    if (forced.isNotEmpty())
+    {
+        for (auto& c : candidates)
+            if (c.supported && forced == c.kernels->name)
+                return *c.kernels;
+
+        DBG("JECHO_DSP_ISA=" << forced << " is unknown or not supported by this CPU, ignoring it");
+    }
+
+    for (auto& c : candidates)
+        if (c.supported)
+            return *c.kernels;
+
+    return scalarKernels;
+}
@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    DspKernels.h
+    Created: 23 Feb 2026 6:31:50pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Block versions of the hot loops in EchoEngine, compiled for several
+// instruction sets and picked at runtime (see select()).
+//
+// All kernels work on a JuceDelayLine ring buffer of lineLength samples whose
+// write position for the first sample of the block is writeIndex. Callers must
+// make sure no read reaches a slot written in the same block (delay > sample
+// offset), which is what lets the taps be read for a whole block at once.
+struct DspKernels
+{
+    // out[i] = gain * sum over taps t of line[writeIndex + i - delays[t][i]]
+    // delays are in (fractional) samples; interpolate = linear, else truncated.
+    using ReadTapsFn = void (*)(const float* line, int lineLength, int writeIndex,
+                                const float* const* delays, int numTaps, int numSamples,
+                                bool interpolate, float gain, float* out);
+
+    // line[writeIndex + i] = clamp(input[i] + delayed[i] * feedback, -1, 1)
+    using WriteFeedbackFn = void (*)(float* line, int lineLength, int writeIndex,
+                                     const float* input, const float* delayed,
+                                     float feedback, int numSamples);
+
+    // io[i] = tanh(gain * (io[i] * (1 - mix) + wet[i] * mix))
+    using OutputStageFn = void (*)(float* io, const float* wet, float mix, float gain, int numSamples);
+
+    // io[i] = tanh(io[i])
+    using SoftClipFn = void (*)(float* io, int numSamples);
+
+    // peak = max(peak, max |data[i]|), sumSquares += sum of data[i]^2
+    using MeasureLevelsFn = void (*)(const float* data, int numSamples, float& peak, float& sumSquares);
+
+    // The tap table read: tap t sits at delay min(baseDelay[i] * ratios[t], maxDelay)
+    // and is read once for both sums
+    //   wet[i]  = sum over t of wetGains[t]  * tap_t[i]
+    //   send[i] = sum over t of sendGains[t] * tap_t[i]
+    using MultiTapFn = void (*)(const float* line, int lineLength, int writeIndex,
+                                const float* baseDelay, const float* ratios,
+                                const float* wetGains, const float* sendGains, int numTaps,
+                                float maxDelay, int numSamples, bool interpolate,
+                                float* wet, float* send);
+
+    // A grain's envelope: envelope[k] = gain * window[(int)((firstAge + k) * windowStep)].
+    // window is a small lookup table, so its reads are gathers.
+    using GrainEnvelopeFn = void (*)(const float* window, int firstAge, float windowStep,
+                                     float gain, float* envelope, int numSamples);
+
+    // out[c][i] = sum over j of matrix[c * numChannels + j] * in[j][i], for every frame i.
+    // out must not overlap in.
+    using MatrixMixFn = void (*)(const float* const* in, float* const* out, const float* matrix,
+                                 int numChannels, int numSamples);
+
+    // (a[i], b[i]) = (a[i] + b[i], a[i] - b[i]), one Hadamard butterfly
+    using ButterflyFn = void (*)(float* a, float* b, int numSamples);
+
+    // Polyphase IIR half-band filters (LoFiResampler) on two channels a and
+    // b at once: the two allpass paths of each are the four lanes a0, a1, b0,
+    // b1 of one step. coefficients holds halfBandStages x 4 lanes, state the
+    // allpass inputs and then outputs in the same layout.
+    //   decimate:    a[j] from a[2j + 1] (path 0) and a[2j] (path 1), the
+    //                same for b, in place, numOut samples out
+    //   interpolate: outA[2i] and outA[2i + 1] from inA[i], the same for b
+    using HalfBandDecimateFn = void (*)(float* state, const float* coefficients,
+                                        float* a, float* b, int numOut);
+    using HalfBandInterpolateFn = void (*)(float* state, const float* coefficients,
+                                           const float* inA, const float* inB,
+                                           float* outA, float* outB, int numSamples);
+
+    // EchoBank's read, all voices at one instant: the line is interleaved by
+    // voice (row r of voice v at line[r * stride + v]) and every voice writes
+    // row writeIndex; delays[t][v] is tap t of voice v in (fractional) samples.
+    //   out[v] = gain * sum over taps t of voice v at row writeIndex - delays[t][v]
+    using VoiceTapsFn = void (*)(const float* line, int lineLength, int stride, int writeIndex,
+                                 const float* const* delays, int numTaps, int numVoices,
+                                 bool interpolate, float gain, float* out);
+
+    // LoopDamping on numRows rows that share its coefficients, in place: per
+    // row a TPT one-pole lowpass (gHigh, if highCutOn) and then a highpass
+    // (gLow, if lowCutOn). lowpassState[r] and highpassState[r] are row r's
+    // integrators. The rows run side by side in the vector lanes.
+    using DampRowsFn = void (*)(float* const* rows, int numRows, int numSamples,
+                                float* lowpassState, float* highpassState,
+                                float gHigh, float gLow, bool highCutOn, bool lowCutOn);
+
+    // A new member goes at the end (before name) and into every table at the
+    // end of DspKernels.cpp, which fill them in this order.
+    ReadTapsFn      readTaps;
+    WriteFeedbackFn writeFeedback;
+    OutputStageFn   outputStage;
+    SoftClipFn      softClip;
+    MeasureLevelsFn measureLevels;
+    ButterflyFn     butterfly;
+    MultiTapFn      multiTap;
+    GrainEnvelopeFn grainEnvelope;
+    MatrixMixFn     matrixMix;
+    HalfBandDecimateFn    halfBandDecimate;
+    HalfBandInterpolateFn halfBandInterpolate;
+    VoiceTapsFn     voiceTaps;
+    DampRowsFn      dampRows;
+    const char*     name;
+
+    static constexpr int maxTaps = 16;
+    static constexpr int halfBandStages = 3;   // allpasses per path
+
+    // The fastest variant this CPU supports. The environment variable
+    // JECHO_DSP_ISA=scalar|sse2|avx2|avx512 forces one (if supported) for testing.
+    static const DspKernels& select();
+
+    static const DspKernels& scalar();
+};
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    EchoBank.cpp
+    Created: 9 Mar 2026 5:04:36pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "EchoBank.h"
+
+void EchoBank::prepare(double sampleRate, int voicesToUse, float maxDelayMsForLongLine)
+{
+    prepare(sampleRate, voicesToUse, maxDelayMsForLongLine, VoiceParameters());
+}
+
+void EchoBank::prepare(double sampleRate, int voicesToUse, float maxDelayMsForLongLine,
+                       const VoiceParameters& initialParameters)
+{
+    jassert(sampleRate > 0);
+    jassert(voicesToUse > 0);
+
+    const int keptVoices = juce::jmin(numVoices, voicesToUse);
+
+    sr = sampleRate;
+    numVoices = voicesToUse;
+    numGroups = (numVoices + groupSize - 1) / groupSize;
+    stride = numGroups * groupSize;
+    maxDelayMs_f = maxDelayMsForLongLine;
+    rampSamples = juce::jmax(1, juce::roundToInt(sr * 0.10));
+    kernels = &DspKernels::select();
+
+    // Same +2 slack as JuceDelayLine for the interpolation neighbour
+    lineLength_s = (int)std::ceil(sr * maxDelayMs_s * 0.001f) + 2;
+    lineLength_f = (int)std::ceil(sr * maxDelayMs_f * 0.001f) + 2;
+
+    line_s.setSize(numGroups, lineLength_s * groupSize);
+    line_f.setSize(numGroups, lineLength_f * groupSize);
+
+    // Voices are columns: the ones kept stay where they are
+    voiceState.setSize(numVoiceRows, stride, true, true);
+
+    for (int row = 0; row < numVoiceRows; ++row)
+        voiceState.clear(row, keptVoices, stride - keptVoices);
+
+    for (int v = keptVoices; v < numVoices; ++v)
+        setVoiceParameters(v, initialParameters);
+
+    // Start every voice at its target instead of ramping to it
+    voiceState.copyFrom(timeS, 0, voiceState, timeSTarget, 0, stride);
+    voiceState.copyFrom(timeF, 0, voiceState, timeFTarget, 0, stride);
+    voiceState.copyFrom(tap3, 0, voiceState, tap3Target, 0, stride);
+    voiceState.clear(rampCountdown, 0, stride);
+    rampSamplesLeft = 0;
+    delaysUpToDate = false;
+
+    reset();
+}
+
+void EchoBank::reset()
+{
+    line_s.clear();
+    line_f.clear();
+    writeIndex_s = 0;
+    writeIndex_f = 0;
+}
+
+void EchoBank::setVoiceParameters(int voice, const VoiceParameters& params)
+{
+    jassert(juce::isPositiveAndBelow(voice, numVoices));
+
+    auto setTarget = [&](int currentRow, int targetRow, int stepRow, float target)
+    {
+        if (voiceState.getSample(targetRow, voice) == target)
+            return;
+
+        voiceState.setSample(targetRow, voice, target);
+        voiceState.setSample(stepRow, voice, (target - voiceState.getSample(currentRow, voice)) / (float)rampSamples);
+        voiceState.setSample(rampCountdown, voice, (float)rampSamples);
+        rampSamplesLeft = rampSamples;
+    };
+
+    setTarget(timeS, timeSTarget, timeSStep, params.timeMs_s);
+    setTarget(timeF, timeFTarget, timeFStep, params.timeMs_f);
+    setTarget(tap3, tap3Target, tap3Step, params.tap3);
+
+    voiceState.setSample(feedbackRow, voice, params.feedback);
+    voiceState.setSample(mixRow, voice, params.mix);
+    voiceState.setSample(gainRow, voice, juce::Decibels::decibelsToGain(params.gainDb));
+}
+
+// One ramp step for every voice; voices whose ramp ended snap to their target.
+void EchoBank::advanceSmoothing() noexcept
+{
+    float* countdown = voiceState.getWritePointer(rampCountdown);
+    float* const current[] = { voiceState.getWritePointer(timeS), voiceState.getWritePointer(timeF), voiceState.getWritePointer(tap3) };
+    const float* const target[] = { voiceState.getReadPointer(timeSTarget), voiceState.getReadPointer(timeFTarget), voiceState.getReadPointer(tap3Target) };
+    const float* const step[] = { voiceState.getReadPointer(timeSStep), voiceState.getReadPointer(timeFStep), voiceState.getReadPointer(tap3Step) };
+
+    for (int k = 0; k < 3; ++k)
+    {
+        float* c = current[k];
+        const float* t = target[k];
+        const float* s = step[k];
+
+        for (int v = 0; v < stride; ++v)
+            c[v] = countdown[v] > 1.0f ? c[v] + s[v] : t[v];
+    }
+
+    for (int v = 0; v < stride; ++v)
+        countdown[v] = juce::jmax(0.0f, countdown[v] - 1.0f);
+}
+
+void EchoBank::updateDelays() noexcept
+{
+    // ms * 0.001 * rate in that order, as JuceDelayLine rounds it
+    const float rate = (float)sr;
+
+    const float* time_s = voiceState.getReadPointer(timeS);
+    const float* time_f = voiceState.getReadPointer(timeF);
+    const float* tap3Mult = voiceState.getReadPointer(tap3);
+    float* delay_s = voiceState.getWritePointer(delayS);
+    float* delay_f1 = voiceState.getWritePointer(delayF1);
+    float* delay_f2 = voiceState.getWritePointer(delayF2);
+    float* delay_f3 = voiceState.getWritePointer(delayF3);
+
+    // The long line's taps: T, T * 1.618 and T * tap3
+    for (int v = 0; v < numVoices; ++v)
+    {
+        delay_s[v] = juce::jlimit(0.0f, maxDelayMs_s, time_s[v]) * 0.001f * rate;
+        delay_f1[v] = juce::jlimit(0.0f, maxDelayMs_f, time_f[v]) * 0.001f * rate;
+        delay_f2[v] = juce::jlimit(0.0f, maxDelayMs_f, time_f[v] * 1.618f) * 0.001f * rate;
+        delay_f3[v] = juce::jlimit(0.0f, maxDelayMs_f, time_f[v] * tap3Mult[v]) * 0.001f * rate;
+    }
+}
+
+void EchoBank::process(const float* const* inputs, float* const* outputs, int numSamples)
+{
+    jassert(numVoices > 0);
+
+    float* const* lines_s = line_s.getArrayOfWritePointers();
+    float* const* lines_f = line_f.getArrayOfWritePointers();
+
+    const float* time_s = voiceState.getReadPointer(timeS);
+    const float* feedback = voiceState.getReadPointer(feedbackRow);
+    const float* mix = voiceState.getReadPointer(mixRow);
+    const float* gain = voiceState.getReadPointer(gainRow);
+    const float* delay_s = voiceState.getReadPointer(delayS);
+    const float* delay_f1 = voiceState.getReadPointer(delayF1);
+    const float* delay_f2 = voiceState.getReadPointer(delayF2);
+    const float* delay_f3 = voiceState.getReadPointer(delayF3);
+
+    float* in = voiceState.getWritePointer(inRow);
+    float* out_s = voiceState.getWritePointer(shortOutRow);
+    float* out_f = voiceState.getWritePointer(longOutRow);
+    float* out = voiceState.getWritePointer(outRow);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Once every ramp has ended the times and delays stay as they are
+        if (rampSamplesLeft > 0)
+        {
+            advanceSmoothing();
+            --rampSamplesLeft;
+            delaysUpToDate = false;
+        }
+
+        if (!delaysUpToDate)
+        {
+            updateDelays();
+            delaysUpToDate = true;
+        }
+
+        for (int v = 0; v < numVoices; ++v)
+            in[v] = inputs[v][i];
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const int first = group * groupSize;
+            const int voicesInGroup = juce::jmin(groupSize, numVoices - first);
+            float* row_s = lines_s[group] + writeIndex_s * groupSize - first;
+            float* row_f = lines_f[group] + writeIndex_f * groupSize - first;
+            const int end = first + voicesInGroup;
+
+            // First delay line, always interpolated whatever setInterpolation says
+            const float* const delays_s[] = { delay_s + first };
+            kernels->voiceTaps(lines_s[group], lineLength_s, groupSize, writeIndex_s, delays_s, 1, voicesInGroup,
+                               true, 1.0f, out_s + first);
+
+            for (int v = first; v < end; ++v)
+            {
+                const bool delayOn_s = time_s[v] >= 1.0f;
+                const float loopIn1 = juce::jlimit(-1.0f, 1.0f, in[v] + out_s[v] * 0.9f);
+
+                row_s[v] = delayOn_s ? loopIn1 : row_s[v];
+                out_s[v] = delayOn_s ? 0.8f * out_s[v] : in[v];
+            }
+
+            // Second delay line: the three taps of every voice
+            const float* const delays_f[] = { delay_f1 + first, delay_f2 + first, delay_f3 + first };
+            kernels->voiceTaps(lines_f[group], lineLength_f, groupSize, writeIndex_f, delays_f, 3, voicesInGroup,
+                               interpolate, 0.35f, out_f + first);
+
+            for (int v = first; v < end; ++v)
+            {
+                row_f[v] = juce::jlimit(-1.0f, 1.0f, out_s[v] + out_f[v] * feedback[v]);
+
+                // Wet = taps + short line output (which is the dry signal when it's off)
+                const float wet = (time_s[v] >= 1.0f ? out_s[v] : 0.0f) + out_f[v];
+                out[v] = (in[v] * (1.0f - mix[v]) + wet * mix[v]) * gain[v];
+            }
+        }
+
+        kernels->softClip(out, numVoices);
+
+        for (int v = 0; v < numVoices; ++v)
+            outputs[v][i] = out[v];
+
+        if (++writeIndex_s >= lineLength_s)
+            writeIndex_s = 0;
+        if (++writeIndex_f >= lineLength_f)
+            writeIndex_f = 0;
+    }
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    EchoBank.h
+    Created: 9 Mar 2026 5:04:36pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+// N independent mono echo voices with the same topology as EchoEngine's
+// Triple Tap (short feedback line into the three-tap long line, mix, gain,
+// tanh), for engines with hundreds of emitters.
+//
+// State is stored structure-of-arrays: every per-voice value is one row of
+// a juce::AudioBuffer, so each processing step is a loop over contiguous
+// voice arrays. Both delay lines are interleaved by voice in groups of 16
+// (one channel per group, sample-major, one write index per line): a
+// sample of a group is one 64-byte row, written with one contiguous store,
+// and each voice's reads move through memory one row per sample instead of
+// jumping a whole bank's row. The taps are read with one
+// DspKernels::voiceTaps gather per group and line, and the smoothing and
+// the delays it feeds are only worked out while some voice is ramping.
+class EchoBank
+{
+public:
+    struct VoiceParameters
+    {
+        float timeMs_s = 0.0f;      // short line, < 1 ms switches it off
+        float timeMs_f = 300.0f;    // long line, first tap
+        float tap3 = 1.618f;        // third tap multiplier
+        float feedback = 0.4f;
+        float mix = 0.5f;
+        float gainDb = 0.0f;
+    };
+
+    EchoBank() = default;
+
+    // Allocates the state for numVoices voices. Voices kept from the last
+    // prepare keep their parameters, new ones get initialParameters; either
+    // way they start at them without a ramp. Not real-time safe.
+    void prepare(double sampleRate, int numVoices, float maxDelayMs_f = 4000.0f);
+    void prepare(double sampleRate, int numVoices, float maxDelayMs_f, const VoiceParameters& initialParameters);
+
+    // Clears the delay lines of all voices.
+    void reset();
+
+    // Times and tap3 ramp over 100 ms like the plugin; the rest applies at once.
+    void setVoiceParameters(int voice, const VoiceParameters& params);
+    // The long line's taps only: the short line always interpolates, like EchoEngine's.
+    void setInterpolation(bool shouldInterpolate) noexcept { interpolate = shouldInterpolate; }
+
+    // inputs[v] / outputs[v] are the mono buffers of voice v (may be the same).
+    void process(const float* const* inputs, float* const* outputs, int numSamples);
+
+    int getNumVoices() const noexcept { return numVoices; }
+
+private:
+    enum VoiceRow
+    {
+        timeS = 0, timeF, tap3,         // current (smoothed) values
+        timeSTarget, timeFTarget, tap3Target,
+        timeSStep, timeFStep, tap3Step,
+        rampCountdown,                  // samples left in the current ramp
+        feedbackRow, mixRow, gainRow,
+        delayS, delayF1, delayF2, delayF3,  // the current times in samples
+        inRow, shortOutRow, longOutRow, outRow,
+        numVoiceRows
+    };
+
+    void advanceSmoothing() noexcept;
+    void updateDelays() noexcept;
+
+    juce::AudioBuffer<float> voiceState;    // numVoiceRows x stride
+    juce::AudioBuffer<float> line_s;        // a channel per group: lineLength_s x groupSize, interleaved by voice
+    juce::AudioBuffer<float> line_f;        // a channel per group: lineLength_f x groupSize
+
+    const DspKernels* kernels = &DspKernels::scalar();
+
+    double sr = 44100.0;
+    int numVoices = 0;
+    static constexpr int groupSize = 16;    // voices per 64-byte line row
+    int numGroups = 0;
+    int stride = 0;                         // numVoices rounded up to whole groups
+    int lineLength_s = 0, lineLength_f = 0;
+    int writeIndex_s = 0, writeIndex_f = 0; // shared by all voices
+    int rampSamples = 1;
+    int rampSamplesLeft = 0;                // until every voice's ramp has ended
+    bool delaysUpToDate = false;
+    float maxDelayMs_s = 200.0f, maxDelayMs_f = 4000.0f;
+    bool interpolate = false;
+};
@@ -0,0 +1,587 @@
+/*
+  ==============================================================================
+
+    EchoEngine.cpp
+    Created: 2 May 2026 8:14:05pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "EchoEngine.h"
+#include <cmath>
+
+//==============================================================================
+EchoEngine::Parameters::Parameters() noexcept
+{
+    // Spread evenly up to 3x, alternating left/right, all feeding back
+    for (int t = 0; t < MultiTapTable::maxTaps; ++t)
+        taps[t] = { MultiTapTable::maxRatio * (float)(t + 1) / (float)MultiTapTable::maxTaps,
+                    1.0f, (t % 2 == 0) ? -0.5f : 0.5f, 1.0f };
+}
+
+//==============================================================================
+void EchoEngine::prepare(double newSampleRate, int maxBlockSize, int numChannels)
+{
+    jassert(newSampleRate > 0);
+
+    sampleRate = newSampleRate;
+
+    // Hosts may still send bigger (or variable) blocks than announced here,
+    // e.g. on offline bounce. process splits those into chunks of this size.
+    maxChunkSize = juce::jmax(1, maxBlockSize);
+    levelMeters.prepare(sampleRate);
+
+    // Pick the DSP kernels for this CPU (JECHO_DSP_ISA overrides it)
+    kernels = &DspKernels::select();
+    scratch.setSize(numScratchChannels, maxChunkSize, false, false, true);
+
+    for (auto* perChannel : { &shortOut, &longIn, &longOut, &loopFeedback, &crossFed })
+        perChannel->setSize(juce::jmax(1, numChannels), maxChunkSize, false, false, true);
+    loopInputs.assign((size_t)juce::jmax(1, numChannels), nullptr);
+    loopFeedbacks.assign((size_t)juce::jmax(1, numChannels), nullptr);
+    crossFeedback.prepare(numChannels);
+    loFi.prepare(numChannels, maxChunkSize);
+
+    // Line lengths from the parameter ranges: the longest long-line read is
+    // TIME_F at its maximum times the largest multiplier, TAP3 for the taps
+    // and the FDN or MultiTapTable::maxRatio (the Glitch sources reach phi^2).
+    const float maxDelayMs_s = maxShortTimeMs;
+    const float maxDelayMs_f = maxLongTimeMs * juce::jmax(maxTap3, MultiTapTable::maxRatio);
+    delayLine_s.prepare(sampleRate, maxDelayMs_s, numChannels);
+    delayLine_f.prepare(sampleRate, maxDelayMs_f, numChannels);
+    damping_s.prepare(sampleRate, numChannels);
+    damping_f.prepare(sampleRate, numChannels);
+    // Only an FDN engine about to run gets its lines now, sized for its N
+    const int engineToRun = juce::jlimit(0, numEngines - 1, params.engine);
+    const bool fdnToRun = engineToRun >= fdn4 && engineToRun <= fdn16;
+    fdn.prepare(sampleRate, maxDelayMs_f, numChannels, maxChunkSize, fdnToRun ? 4 << (engineToRun - fdn4) : 0);
+    grains.prepare(sampleRate, maxChunkSize);
+    // Time smoothing: 0.05 seconds (50 ms) ramp time is a nice starting point
+    timeMsSmoothed_s.reset(sampleRate, 0.10); // rampTimeSeconds
+    timeMsSmoothed_f.reset(sampleRate, 0.10); // rampTimeSeconds
+    tap3Smoothed.reset(sampleRate, 0.10f); // 10 ms ramp, same as time
+    // Start the smoothed value at the current parameter value
+    timeMsSmoothed_s.setCurrentAndTargetValue(params.timeMs_s);
+    timeMsSmoothed_f.setCurrentAndTargetValue(params.timeMs_f);
+    tap3Smoothed.setCurrentAndTargetValue(params.tap3);
+
+    // One second of margin past the longest line (at the full rate, LOFI or not)
+    idleAfterSamples = (juce::int64)std::ceil(maxDelayMs_f * 0.001 * sampleRate) + (juce::int64)sampleRate;
+    silentSamples = 0;
+    idle = false;
+    hibernating = false;
+}
+
+void EchoEngine::release()
+{
+    // Hibernate: give back the delay lines, by far the bulk of the memory.
+    // The tails go with them; the next prepare starts from empty lines.
+    delayLine_s.release();
+    delayLine_f.release();
+    fdn.release();
+    damping_s.reset();
+    damping_f.reset();
+    grains.reset();
+    loFi.reset();
+    hibernating = true;
+}
+
+void EchoEngine::resetEngine(int engine) noexcept
+{
+    if (engine >= fdn4 && engine <= fdn16)
+    {
+        // Constant time whatever the size, nothing is cleared (FeedbackDelayNetwork.h)
+        fdn.setNumLines(4 << (engine - fdn4));
+        fdn.reset();
+    }
+    else
+    {
+        delayLine_f.reset();
+        damping_f.reset();
+        grains.reset();
+        loFi.reset();
+    }
+}
+
+float EchoEngine::getMagnitude(float* const* channels, int numChannels, int numSamples) noexcept
+{
+    float magnitude = 0.0f;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(channels[channel], numSamples);
+        magnitude = juce::jmax(magnitude, -range.getStart(), range.getEnd());
+    }
+
+    return magnitude;
+}
+
+void EchoEngine::process(float* const* channels, int numChannels, int numSamples) noexcept
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    jassert((size_t)numChannels <= loopInputs.size());
+
+    // Released and not prepared again: there are no lines to run
+    if (hibernating)
+        return;
+
+    const bool metering = levelMeters.isActive();
+
+    if (metering)
+        for (int channel = 0; channel < numChannels; ++channel)
+            levelMeters.measure(*kernels, LevelMeters::input, channels[channel], numSamples);
+
+    // ===== Bypass =====
+    const bool bypass = params.bypassed;
+
+    if (bypass != lastBypassed)
+    {
+        // effect just turned ON: start from empty lines, the short one and
+        // whichever the active engine reads
+        if (!bypass)
+        {
+            delayLine_s.reset();
+            damping_s.reset();
+            resetEngine(activeEngine);
+        }
+
+        lastBypassed = bypass;
+    }
+
+    // ===== Idle =====
+    // Nothing moves while idle, so processing picks up exactly where it stopped.
+    const bool inputSilent = getMagnitude(channels, numChannels, numSamples) < silenceLevel;
+    idle = inputSilent && silentSamples >= idleAfterSamples;
+    measuringWet = inputSilent;
+    wetMagnitude = 0.0f;
+
+    // now do the actual bypass logic
+    if (!bypass && !idle)
+    {
+        // ===== Chunking =====
+        // Never process more than the prepared block size in one go, so anything
+        // sized in prepare is never outgrown on the audio thread.
+        for (int start = 0; start < numSamples; start += maxChunkSize)
+            processChunk(channels, numChannels, start, juce::jmin(maxChunkSize, numSamples - start));
+    }
+
+    if (inputSilent && wetMagnitude < silenceLevel
+        && getMagnitude(channels, numChannels, numSamples) < silenceLevel)
+        silentSamples += numSamples;
+    else
+        silentSamples = 0;
+
+    if (metering)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            levelMeters.measure(*kernels, LevelMeters::output, channels[channel], numSamples);
+
+        levelMeters.endBlock(numSamples);
+    }
+}
+
+void EchoEngine::processChunk(float* const* channels, int numChannels,
+    int startSample, int numSamples) noexcept
+{
+    // ===== Parameter block (read once per chunk) =====
+    const float timeMsTarget_s = params.timeMs_s;       // base delay time in ms
+    const float timeMsTarget_f = params.timeMs_f;       // base delay time in ms
+    const float feedback_s = 0.9;//hard setting for first delay line
+    const float feedback_f = params.feedback;   // 0..0.95
+    const float mix = params.mix;        // 0..1
+    const float gainDb = params.gainDb;       // dB
+    const float outGain = juce::Decibels::decibelsToGain(gainDb);
+    const bool  useInterp = params.interpolate;
+    const float tap3Target = params.tap3;
+    const bool  metering = levelMeters.isActive();
+
+    damping_s.setCutoffs(params.dampHighHz, params.dampLowHz);
+    fdn.setDamping(params.dampHighHz, params.dampLowHz);
+
+    // ===== Engine =====
+    // The engine being switched to starts from empty lines
+    const int engine = juce::jlimit(0, numEngines - 1, params.engine);
+    if (engine != activeEngine)
+    {
+        resetEngine(engine);
+        activeEngine = engine;
+    }
+
+    const bool fdnOn = activeEngine >= 1 && activeEngine <= 3;
+    const bool multiTapOn = activeEngine == 4;
+    const bool glitchOn = activeEngine == 5;
+
+    // The FDN's lines come and go with the FDN engines
+    if (fdnOn)
+        fdn.acquireLines();
+    else
+        fdn.dropLines();
+
+    if (glitchOn)
+        grains.setParameters(params.grainSizeMs, params.grainDensity, params.grainRepeats);
+
+    // The FDN already mixes its own lines; the other engines may cross-feed
+    crossFeedback.update(fdnOn ? (int)CrossFeedbackMatrix::off : params.crossFeed,
+                         params.crossWidth, numChannels);
+
+    if (multiTapOn)
+        multiTapTable.update(params.taps, params.numTaps, numChannels);
+
+    const float smallestTapRatio = multiTapOn ? multiTapTable.getSmallestRatio() : 1.0f;
+
+    // ===== Lo-fi =====
+    // Triple Tap and Multi Tap can run the long line at 1/2 or 1/4 rate; its
+    // delays are then counted in those samples. A change starts it empty.
+    const int loFiFactor = (activeEngine == 0 || multiTapOn) ? 1 << juce::jlimit(0, 2, params.loFi) : 1;
+    if (loFiFactor != delayLine_f.getRateDivisor())
+    {
+        delayLine_f.setRateDivisor(loFiFactor);
+        damping_f.reset();
+        loFi.setFactor(loFiFactor);
+        crossfadeActive = false;
+    }
+
+    damping_f.setCutoffs(params.dampHighHz, params.dampLowHz, loFiFactor);
+
+    // ===== Time change mode =====
+    // Crossfade only concerns the three taps (Triple Tap and Glitch); the
+    // other engines always glide. Its times jump, so the smoothers are kept
+    // on target for a later switch back to Glide.
+    const bool crossfadeOn = params.crossfadeTimes && (activeEngine == 0 || glitchOn);
+
+    if (crossfadeOn)
+    {
+        timeMsSmoothed_f.setCurrentAndTargetValue(timeMsTarget_f);
+        tap3Smoothed.setCurrentAndTargetValue(tap3Target);
+        tapCrossfade.setLength(juce::roundToInt(params.crossfadeMs * 0.001 * delayLine_f.getRate()));
+
+        if (!crossfadeActive)
+        {
+            const float delays[] = { delayLine_f.getDelaySamples(timeMsTarget_f),
+                                     delayLine_f.getDelaySamples(timeMsTarget_f * 1.618f),
+                                     delayLine_f.getDelaySamples(timeMsTarget_f * tap3Target) };
+            tapCrossfade.reset(delays);
+        }
+    }
+
+    crossfadeActive = crossfadeOn;
+
+
+    timeMsSmoothed_s.setTargetValue(timeMsTarget_s);
+    timeMsSmoothed_f.setTargetValue(timeMsTarget_f);
+    tap3Smoothed.setTargetValue(tap3Target);
+
+    // ===== Delay curves (shared by all channels) =====
+    // Smoothed tap times for every sample of the chunk, already in samples.
+    // The long line's are at its own rate: in LOFI only at the samples the
+    // reduced ones line up with, packed from index 0.
+    float* delay_s = scratch.getWritePointer(delayShortScratch);
+    float* delay_f_1 = scratch.getWritePointer(delayTap1Scratch);
+    float* delay_f_2 = scratch.getWritePointer(delayTap2Scratch);
+    float* delay_f_3 = scratch.getWritePointer(delayTap3Scratch);
+    float* newDelay_f_1 = scratch.getWritePointer(newTap1Scratch);
+    float* newDelay_f_2 = scratch.getWritePointer(newTap2Scratch);
+    float* newDelay_f_3 = scratch.getWritePointer(newTap3Scratch);
+    float* crossfadeRamp = scratch.getWritePointer(crossfadeRampScratch);
+
+    int nextLong = loFiFactor == 1 ? 0 : loFi.getFirstIndex();
+    int numLong = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float timeMsSmoothedNow_s = timeMsSmoothed_s.getNextValue();
+        const float timeMsSmoothedNow_f = timeMsSmoothed_f.getNextValue();
+        const float tap3MultNow = tap3Smoothed.getNextValue();
+
+        // Below 1 ms the short line is switched off; -1 marks that
+        delay_s[i] = (timeMsSmoothedNow_s < 1.0f) ? -1.0f : delayLine_s.getDelaySamples(timeMsSmoothedNow_s);
+
+        if (i != nextLong)
+            continue;
+
+        nextLong += loFiFactor;
+        const int j = numLong++;
+
+        delay_f_1[j] = delayLine_f.getDelaySamples(timeMsSmoothedNow_f);
+        // Second tap is 1.6x the first
+        delay_f_2[j] = delayLine_f.getDelaySamples(timeMsSmoothedNow_f * 1.618f);
+        // user-controlled tap 3
+        delay_f_3[j] = delayLine_f.getDelaySamples(timeMsSmoothedNow_f * tap3MultNow);
+
+        // FDN line 0 equals tap 1, the other lines are longer
+        if (fdnOn)
+            fdn.setDelays(j, timeMsSmoothedNow_f, tap3MultNow);
+
+        // Crossfade: the tap curves become the old heads, plus the new ones
+        if (crossfadeOn)
+        {
+            float heads[] = { delay_f_1[j], delay_f_2[j], delay_f_3[j] };
+            float newHeads[TapCrossfade::numTaps];
+
+            crossfadeRamp[j] = tapCrossfade.next(heads, newHeads);
+
+            delay_f_1[j] = heads[0];
+            delay_f_2[j] = heads[1];
+            delay_f_3[j] = heads[2];
+            newDelay_f_1[j] = newHeads[0];
+            newDelay_f_2[j] = newHeads[1];
+            newDelay_f_3[j] = newHeads[2];
+        }
+    }
+
+    // ===== Short line =====
+    // Over the whole chunk first: it only depends on the input. Its output
+    // goes to shortOut (zero while it is off) and the long line's input,
+    // that output or the dry signal, to longIn. Sub-blocks end before the
+    // tap reaches a sample written inside them, where the line switches on
+    // or off and at the ring's length (while off nothing else bounds them).
+    float* loopFiltered = scratch.getWritePointer(loopFilterScratch);
+    const int maxLength_s = delayLine_s.getBufferLength();
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const bool delayOff_s = delay_s[pos] < 0.0f;
+        int length = 0;
+
+        while (pos + length < numSamples && length < maxLength_s)
+        {
+            const int i = pos + length;
+
+            if ((delay_s[i] < 0.0f) != delayOff_s
+                || (!delayOff_s && (int)delay_s[i] <= length))
+                break;
+
+            ++length;
+        }
+
+        length = juce::jmax(1, length);
+
+        const float* tapDelays_s[] = { delay_s + pos };
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* channelData = channels[channel] + startSample + pos;
+            float* out_s = shortOut.getWritePointer(channel, pos);
+            float* in_f = longIn.getWritePointer(channel, pos);
+
+            if (delayOff_s)
+            {
+                juce::FloatVectorOperations::clear(out_s, length);
+                juce::FloatVectorOperations::copy(in_f, channelData, length);
+                continue;
+            }
+
+            //First delay line: short delay time
+            kernels->readTaps(delayLine_s.getReadPointer(channel), delayLine_s.getBufferLength(),
+                              delayLine_s.getWriteIndex(), tapDelays_s, 1, length, true, 1.0f, out_s);
+
+            if (metering)
+                levelMeters.measure(*kernels, LevelMeters::shortLoop, out_s, length);
+
+            // feedback inside delay1 (with safety clip), damped if enabled
+            const float* fed_s = out_s;
+            if (damping_s.isActive())
+            {
+                damping_s.process(channel, out_s, loopFiltered, length);
+                fed_s = loopFiltered;
+            }
+
+            kernels->writeFeedback(delayLine_s.getWritePointer(channel), delayLine_s.getBufferLength(),
+                                   delayLine_s.getWriteIndex(), channelData, fed_s, feedback_s, length);
+
+            for (int i = 0; i < length; ++i)
+                out_s[i] *= 0.8f; // output of first delay
+
+            juce::FloatVectorOperations::copy(in_f, out_s, length);
+        }
+
+        delayLine_s.advance(length);
+        pos += length;
+    }
+
+    // ===== Long line / engine =====
+    // Reads longIn and the curves from sample 0 and writes longOut, over n
+    // samples at the long line's rate. The taps of a whole sub-block can be
+    // read at once as long as none of them reaches a sample written inside
+    // that sub-block (delay > offset); sub-blocks also end where a crossfade
+    // starts or ends, and never wrap the ring more than once per write.
+    const float* tapDelays_f[] = { delay_f_1, delay_f_2, delay_f_3 };
+    const float* newTapDelays_f[] = { newDelay_f_1, newDelay_f_2, newDelay_f_3 };
+    float* crossfadeRead = scratch.getWritePointer(crossfadeReadScratch);
+    const int maxLength_f = fdnOn ? fdn.getLineLength() : delayLine_f.getBufferLength();
+
+    auto processLongLine = [&](int n)
+    {
+        for (int pos = 0; pos < n;)
+        {
+            const bool fading = crossfadeOn && crossfadeRamp[pos] >= 0.0f;
+            int length = 0;
+
+            while (pos + length < n && length < maxLength_f)
+            {
+                const int i = pos + length;
+
+                if ((int)delay_f_1[i] <= length
+                    || (int)delay_f_2[i] <= length
+                    || (int)delay_f_3[i] <= length
+                    || (multiTapOn && (int)(delay_f_1[i] * smallestTapRatio) <= length)
+                    || (crossfadeOn && (crossfadeRamp[i] >= 0.0f) != fading)
+                    || (fading && ((int)newDelay_f_1[i] <= length
+                                   || (int)newDelay_f_2[i] <= length
+                                   || (int)newDelay_f_3[i] <= length)))
+                    break;
+
+                ++length;
+            }
+
+            length = juce::jmax(1, length);
+
+            // Grain onsets are placed to the sample, before any channel reads them
+            if (glitchOn)
+                grains.schedule(*kernels, delay_f_1 + pos, length, delayLine_f.getWriteIndex(),
+                                delayLine_f.getBufferLength());
+
+            const float* tapDelaysNow_f[] = { tapDelays_f[0] + pos, tapDelays_f[1] + pos, tapDelays_f[2] + pos };
+            const float* newTapDelaysNow_f[] = { newTapDelays_f[0] + pos, newTapDelays_f[1] + pos, newTapDelays_f[2] + pos };
+
+            // ----- Reads: every channel's echoes and long-line feedback -----
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const float* input_f = longIn.getReadPointer(channel, pos);
+                float* out_f = longOut.getWritePointer(channel, pos);
+                float* fed_f = loopFeedback.getWritePointer(channel);
+
+                loopInputs[(size_t)channel] = input_f;
+
+                if (fdnOn)
+                {
+                    // Second stage: the feedback delay network instead of the three taps
+                    fdn.process(*kernels, channel, pos, input_f, feedback_f, useInterp, out_f, length);
+
+                    if (metering)
+                        levelMeters.measure(*kernels, LevelMeters::longLoop, out_f, length);
+                }
+                else if (multiTapOn)
+                {
+                    // Second delay line read through the tap table: panned taps
+                    // into out_f, the send mix into fed_f, one gather each
+                    kernels->multiTap(delayLine_f.getReadPointer(channel), delayLine_f.getBufferLength(),
+                                      delayLine_f.getWriteIndex(), delay_f_1 + pos, multiTapTable.getRatios(),
+                                      multiTapTable.getWetGains(channel), multiTapTable.getSendGains(), multiTapTable.getNumTaps(),
+                                      delayLine_f.getMaxDelaySamples(), length, useInterp, out_f, fed_f);
+
+                    if (metering)
+                        levelMeters.measure(*kernels, LevelMeters::longLoop, out_f, length);
+
+                    if (damping_f.isActive())
+                        damping_f.process(channel, fed_f, fed_f, length);
+
+                    loopFeedbacks[(size_t)channel] = fed_f;
+                }
+                else
+                {
+                    // Second delay line: three taps, summed with a fixed 0.35 gain.
+                    // Crossfade mode reads whole samples only, both heads while fading.
+                    kernels->readTaps(delayLine_f.getReadPointer(channel), delayLine_f.getBufferLength(),
+                                      delayLine_f.getWriteIndex(), tapDelaysNow_f, 3, length,
+                                      useInterp && !crossfadeOn, 0.35f, out_f);
+
+                    if (fading)
+                    {
+                        kernels->readTaps(delayLine_f.getReadPointer(channel), delayLine_f.getBufferLength(),
+                                          delayLine_f.getWriteIndex(), newTapDelaysNow_f, 3, length, false, 0.35f, crossfadeRead);
+
+                        const float* ramp = crossfadeRamp + pos;
+                        for (int i = 0; i < length; ++i)
+                            out_f[i] += ramp[i] * (crossfadeRead[i] - out_f[i]);
+                    }
+
+                    if (metering)
+                        levelMeters.measure(*kernels, LevelMeters::longLoop, out_f, length);
+
+                    // Only the repeats are damped, the first echo keeps its full band
+                    if (damping_f.isActive())
+                        damping_f.process(channel, out_f, fed_f, length);
+
+                    loopFeedbacks[(size_t)channel] = damping_f.isActive() ? fed_f : out_f;
+                }
+            }
+
+            // ----- Cross feedback: all channels' feedback through the matrix -----
+            if (!crossFeedback.isIdentity())
+            {
+                kernels->matrixMix(loopFeedbacks.data(), crossFed.getArrayOfWritePointers(),
+                                   crossFeedback.getCoefficients(), numChannels, length);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    loopFeedbacks[(size_t)channel] = crossFed.getReadPointer(channel);
+            }
+
+            // ----- Writes -----
+            if (!fdnOn)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    kernels->writeFeedback(delayLine_f.getWritePointer(channel), delayLine_f.getBufferLength(),
+                                           delayLine_f.getWriteIndex(), loopInputs[(size_t)channel],
+                                           loopFeedbacks[(size_t)channel], feedback_f, length);
+
+                    // Glitch: the stutters go on top of the taps, after the write
+                    // so grains as short as one sample back find their source
+                    if (glitchOn)
+                        grains.render(delayLine_f.getReadPointer(channel), delayLine_f.getBufferLength(),
+                                      longOut.getWritePointer(channel, pos), length);
+                }
+            }
+
+            // After all channels for this sub-block: advance the write indices
+            delayLine_f.advance(length);
+            if (fdnOn)
+                fdn.advance(length);
+            if (glitchOn)
+                grains.advance(length, delayLine_f.getBufferLength());
+            pos += length;
+        }
+    };
+
+    if (loFiFactor == 1)
+    {
+        processLongLine(numLong);
+    }
+    else
+    {
+        // Down to the line's rate, longIn in place; the curves already are.
+        // Then the wet signal back up.
+        jassert(numLong == loFi.getNumReduced(numSamples));
+
+        loFi.decimate(*kernels, longIn.getArrayOfWritePointers(), numChannels, numSamples);
+
+        processLongLine(numLong);
+
+        loFi.interpolate(*kernels, longOut.getArrayOfReadPointers(), longOut.getArrayOfWritePointers(),
+                         numChannels, numSamples);
+
+        loFi.advance(numSamples);
+    }
+
+    // ===== Output =====
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* channelData = channels[channel] + startSample;
+        const float* out_s = shortOut.getReadPointer(channel);
+        float* out_f = longOut.getWritePointer(channel);
+
+        // Wet signal = taps + first delay line output (zero while it is off)
+        for (int i = 0; i < numSamples; ++i)
+            out_f[i] += out_s[i];
+
+        // For the idle test: what the loops put out, heard or not
+        if (measuringWet)
+            wetMagnitude = juce::jmax(wetMagnitude, getMagnitude(&out_f, 1, numSamples));
+
+        // ---- Mix + gain block ----
+        kernels->outputStage(channelData, out_f, mix, outGain, numSamples);
+    }
+}
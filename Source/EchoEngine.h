@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    EchoEngine.h
+    Created: 2 May 2026 8:14:05pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "JuceDelayLine.h"
+#include "DspKernels.h"
+#include "LevelMeters.h"
+#include "LoopDamping.h"
+#include "FeedbackDelayNetwork.h"
+#include "MultiTapTable.h"
+#include "GrainEngine.h"
+#include "CrossFeedbackMatrix.h"
+#include "TapCrossfade.h"
+#include "LoFiResampler.h"
+#include <vector>
+
+// The whole echo without a processor around it: both delay lines and their
+// smoothing, the engines, the feedback topology and the output stage. It
+// only needs juce_core and juce_audio_basics, so it also builds on its own
+// as the JECHOEngine static library (Engine/JECHOEngine.jucer) for hosts
+// that want the sound without the plugin, the APVTS or any GUI module.
+// MagicGUIAudioProcessor is a thin wrapper that copies its parameters in
+// once per block.
+//
+// prepare first; then setParameters and process from one thread, normally
+// the audio thread. Neither allocates: the FDN's lines, which only exist
+// while an FDN engine is selected, are laid out on a background thread
+// (FeedbackDelayNetwork.h). release gives the lines back until the next
+// prepare.
+class EchoEngine
+{
+public:
+    // The ranges the lines are sized for; the plugin's parameters use the same.
+    static constexpr float maxShortTimeMs = 200.0f;
+    static constexpr float maxLongTimeMs = 1200.0f;
+    static constexpr float maxTap3 = 3.0f;
+
+    enum Engine
+    {
+        tripleTap = 0,
+        fdn4,
+        fdn8,
+        fdn16,
+        multiTap,
+        glitch,
+        numEngines
+    };
+
+    // Plain values in the units of the plugin's parameters, with the same
+    // defaults except bypassed.
+    struct Parameters
+    {
+        Parameters() noexcept;
+
+        float timeMs_s = 0.0f;          // short line, off below 1 ms
+        float timeMs_f = 300.0f;        // long line
+        float tap3 = 1.618f;            // third tap, times timeMs_f
+        float feedback = 0.4f;          // long line
+        float mix = 0.5f;
+        float gainDb = 0.0f;
+        bool  bypassed = false;         // the plugin's BYPASS is the other way round (1 = effect on)
+        bool  interpolate = false;
+        float dampHighHz = LoopDamping::highCutOffHz;
+        float dampLowHz = LoopDamping::lowCutOffHz;
+        int   engine = tripleTap;
+        int   numTaps = 8;              // Multi Tap table
+        MultiTapTable::Tap taps[MultiTapTable::maxTaps];
+        float grainSizeMs = 60.0f;      // Glitch
+        float grainDensity = 12.0f;     // grains per second
+        int   grainRepeats = 3;
+        int   crossFeed = CrossFeedbackMatrix::off;
+        float crossWidth = 1.0f;
+        bool  crossfadeTimes = false;   // TIME_MODE Crossfade rather than Glide
+        float crossfadeMs = 50.0f;
+        int   loFi = 0;                 // 0 full rate, 1 half, 2 quarter
+    };
+
+    EchoEngine() = default;
+
+    // Sizes everything for up to maxBlockSize samples of numChannels. Call
+    // setParameters first: the smoothed times start at its values. The lines
+    // keep their contents when nothing changed since the last prepare.
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+
+    // Frees the delay lines; process passes the input through until the next prepare.
+    void release();
+
+    // Offline rendering: the FDN's lines are laid out in process itself when
+    // an FDN engine is switched to, rather than in the background, so the
+    // output doesn't depend on timing. Like AudioProcessor::setNonRealtime.
+    void setNonRealtime(bool isNonRealtime) noexcept { fdn.setNonRealtime(isNonRealtime); }
+
+    // Picked up by the next process call.
+    void setParameters(const Parameters& newParameters) noexcept { params = newParameters; }
+    const Parameters& getParameters() const noexcept             { return params; }
+
+    // In place, numChannels up to the prepared count. Any block size: longer
+    // blocks are split into chunks of the prepared one.
+    void process(float* const* channels, int numChannels, int numSamples) noexcept;
+
+    void process(juce::AudioBuffer<float>& buffer) noexcept
+    {
+        process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    }
+
+    // Whether the last process call skipped the DSP on silence.
+    bool isIdle() const noexcept { return idle; }
+
+    // Peak and RMS of the input, output and both loops, while setActive(true).
+    LevelMeters& getLevelMeters() noexcept { return levelMeters; }
+
+private:
+    // Processes at most maxChunkSize samples starting at startSample.
+    void processChunk(float* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+
+    static float getMagnitude(float* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Empties only what the given engine reads: the FDN's lines or the long
+    // line with its damping, grains and lo-fi filters.
+    void resetEngine(int engine) noexcept;
+
+    Parameters params;
+    double sampleRate = 44100.0;
+
+    JuceDelayLine delayLine_s;
+    JuceDelayLine delayLine_f;
+
+    // High/low cut inside each feedback loop
+    LoopDamping damping_s;
+    LoopDamping damping_f;
+
+    // ENGINE 1..3: the long line is replaced by a 4/8/16 line FDN
+    FeedbackDelayNetwork fdn;
+    int activeEngine = tripleTap;
+
+    // ENGINE 4: the three fixed taps of delayLine_f become a table of up to 16
+    MultiTapTable multiTapTable;
+
+    // ENGINE 5: the three taps keep running, stutter grains are read on top
+    GrainEngine grains;
+
+    // Routes the long line's feedback between channels (not in the FDN modes)
+    CrossFeedbackMatrix crossFeedback;
+
+    juce::LinearSmoothedValue<float> timeMsSmoothed_s;
+    juce::LinearSmoothedValue<float> timeMsSmoothed_f;
+    juce::LinearSmoothedValue<float> tap3Smoothed;
+
+    // TIME_MODE Crossfade: the three taps fade between integer read heads instead
+    TapCrossfade tapCrossfade;
+    bool crossfadeActive = false;
+
+    // LOFI: the long line of Triple Tap and Multi Tap at 1/2 or 1/4 rate
+    LoFiResampler loFi;
+
+    int maxChunkSize = 512; // maxBlockSize from the last prepare
+    bool lastBypassed = false;
+
+    // Hibernation: between release and the next prepare the delay lines are
+    // freed and process passes the input through.
+    bool hibernating = false;
+
+    // Idle: silent input, output and wet signal samples in a row. The wet
+    // signal counts even when MIX hides it, as the loops still ring. After
+    // idleAfterSamples (longer than the longest delay) the lines hold
+    // nothing audible and the DSP is skipped until the input comes back.
+    static constexpr float silenceLevel = 1.0e-6f; // -120 dBFS
+    juce::int64 silentSamples = 0;
+    juce::int64 idleAfterSamples = 0;
+    bool idle = false;
+    bool measuringWet = false;     // the block's input is silent
+    float wetMagnitude = 0.0f;     // peak of the block's wet signal so far
+
+    // Per-chunk working memory, sized in prepare
+    enum ScratchChannel
+    {
+        delayShortScratch = 0,
+        delayTap1Scratch,
+        delayTap2Scratch,
+        delayTap3Scratch,
+        newTap1Scratch,          // Crossfade mode: the new read heads,
+        newTap2Scratch,
+        newTap3Scratch,
+        crossfadeRampScratch,    // how far the fade is, -1 when there is none
+        crossfadeReadScratch,    // and what the new heads read
+        loopFilterScratch,
+        numScratchChannels
+    };
+
+    juce::AudioBuffer<float> scratch;
+
+    // Per channel, so every channel's feedback exists before any is written back
+    juce::AudioBuffer<float> shortOut;       // short line output
+    juce::AudioBuffer<float> longIn;         // long line input: short line output or dry (decimated in LOFI)
+    juce::AudioBuffer<float> longOut;        // long line / engine wet output
+    juce::AudioBuffer<float> loopFeedback;   // what the long line feeds back, damped
+    juce::AudioBuffer<float> crossFed;       // loopFeedback after the cross-feedback matrix
+    std::vector<const float*> loopInputs;    // per channel: what goes into the long line
+    std::vector<const float*> loopFeedbacks; // per channel: what is fed back (one of the above)
+    const DspKernels* kernels = &DspKernels::scalar();
+
+    LevelMeters levelMeters;
+
+    JUCE_DECLARE_NON_COPYABLE (EchoEngine)
+};
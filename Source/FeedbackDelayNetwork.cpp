@@ -0,0 +1,325 @@
+/*
+  ==============================================================================
+
+    FeedbackDelayNetwork.cpp
+    Created: 11 Apr 2026 6:55:20pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "FeedbackDelayNetwork.h"
+
+namespace
+{
+    const int allocatorIntervalMs = 10;
+}
+
+// The background thread behind every network's lines, shared through a
+// juce::SharedResourcePointer. It polls rather than being woken: waking a
+// thread takes a lock the audio thread must never wait on.
+class FeedbackDelayNetwork::Allocator : private juce::Thread
+{
+public:
+    Allocator() : juce::Thread("JECHO FDN lines") { startThread(); }
+    ~Allocator() override { stopThread(1000); }
+
+    void add(FeedbackDelayNetwork* network)
+    {
+        const juce::ScopedLock sl(lock);
+        networks.add(network);
+    }
+
+    void remove(FeedbackDelayNetwork* network)
+    {
+        const juce::ScopedLock sl(lock);
+        networks.removeFirstMatchingValue(network);
+    }
+
+    // Held while a network's lines are laid out or freed off the audio thread
+    juce::CriticalSection lock;
+
+private:
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(allocatorIntervalMs);
+
+            const juce::ScopedLock sl(lock);
+
+            for (auto* network : networks)
+                network->serviceRequest();
+        }
+    }
+
+    juce::Array<FeedbackDelayNetwork*> networks;
+};
+
+//==============================================================================
+FeedbackDelayNetwork::FeedbackDelayNetwork()
+{
+    allocator->add(this);
+}
+
+FeedbackDelayNetwork::~FeedbackDelayNetwork()
+{
+    allocator->remove(this);
+    freeHandedBack();
+    delete ready.exchange(nullptr);
+}
+
+void FeedbackDelayNetwork::prepare(double sampleRate, float maxDelayMs, int numChannels, int maxBlockSize,
+                                   int numLinesToAllocate)
+{
+    {
+        const juce::ScopedLock sl(allocator->lock);
+
+        freeHandedBack();
+        delete ready.exchange(nullptr);
+        requestedLines = 0;
+        linesAskedFor = 0;
+
+        rate = sampleRate;
+        maxDelay = maxDelayMs;
+        channels = numChannels;
+    }
+
+    if (numLinesToAllocate == 0)
+    {
+        lines.reset();
+    }
+    else if (lines != nullptr && lines->getNumChannels() == numChannels * numLinesToAllocate)
+    {
+        // Laid out anew: cleared for real, nothing stale to hide
+        if (lines->prepare(sampleRate, maxDelayMs, numChannels * numLinesToAllocate))
+            samplesSinceReset = lines->getBufferLength();
+    }
+    else
+    {
+        lines = createLines(numLinesToAllocate);
+        samplesSinceReset = lines->getBufferLength();
+    }
+
+    damping.prepare(sampleRate, numChannels * maxLines);
+    delays.setSize(maxLines, maxBlockSize, false, false, true);
+    lineOut.setSize(maxLines, maxBlockSize, false, false, true);
+}
+
+void FeedbackDelayNetwork::reset() noexcept
+{
+    if (lines != nullptr)
+    {
+        resetIndex = lines->getWriteIndex();
+        samplesSinceReset = 0;
+    }
+
+    damping.reset();
+}
+
+void FeedbackDelayNetwork::release()
+{
+    {
+        const juce::ScopedLock sl(allocator->lock);
+
+        freeHandedBack();
+        delete ready.exchange(nullptr);
+        requestedLines = 0;
+        linesAskedFor = 0;
+    }
+
+    lines.reset();
+    damping.reset();
+}
+
+std::unique_ptr<JuceDelayLine> FeedbackDelayNetwork::createLines(int linesPerChannel) const
+{
+    auto newLines = std::make_unique<JuceDelayLine>();
+    newLines->prepare(rate, maxDelay, channels * linesPerChannel);
+    return newLines;
+}
+
+void FeedbackDelayNetwork::serviceRequest()
+{
+    freeHandedBack();
+
+    // One set of lines in flight at a time; the audio thread hands back any
+    // that no longer fit by the time they arrive
+    if (ready.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    if (const int wanted = requestedLines.exchange(0, std::memory_order_acq_rel); wanted > 0)
+        ready.store(createLines(wanted).release(), std::memory_order_release);
+}
+
+void FeedbackDelayNetwork::freeHandedBack()
+{
+    for (auto& slot : handedBack)
+        delete slot.exchange(nullptr, std::memory_order_acquire);
+}
+
+void FeedbackDelayNetwork::handBack(JuceDelayLine* old) noexcept
+{
+    if (old == nullptr)
+        return;
+
+    for (auto& slot : handedBack)
+    {
+        JuceDelayLine* empty = nullptr;
+
+        if (slot.compare_exchange_strong(empty, old, std::memory_order_release))
+            return;
+    }
+
+    // At most two lines come back per allocator pass
+    jassertfalse;
+    delete old;
+}
+
+void FeedbackDelayNetwork::swapIn(JuceDelayLine* newLines) noexcept
+{
+    handBack(lines.release());
+    lines.reset(newLines);
+
+    // Fresh lines are cleared: nothing stale to hide
+    samplesSinceReset = lines->getBufferLength();
+    damping.reset();
+}
+
+void FeedbackDelayNetwork::acquireLines() noexcept
+{
+    const int rowsWanted = channels * numLines;
+
+    if (ready.load(std::memory_order_relaxed) != nullptr)
+    {
+        auto* incoming = ready.exchange(nullptr, std::memory_order_acquire);
+
+        if (incoming->getNumChannels() == rowsWanted
+            && (lines == nullptr || lines->getNumChannels() != rowsWanted))
+            swapIn(incoming);
+        else
+            handBack(incoming);
+    }
+
+    if (lines != nullptr && lines->getNumChannels() == rowsWanted)
+    {
+        if (linesAskedFor != 0)
+        {
+            linesAskedFor = 0;
+            requestedLines.store(0, std::memory_order_release);
+        }
+
+        return;
+    }
+
+    // Laid out for another N: no use any more
+    handBack(lines.release());
+
+    if (nonRealtime)
+    {
+        swapIn(createLines(numLines).release());
+        return;
+    }
+
+    if (linesAskedFor != numLines)
+    {
+        linesAskedFor = numLines;
+        requestedLines.store(numLines, std::memory_order_release);
+    }
+}
+
+void FeedbackDelayNetwork::dropLines() noexcept
+{
+    if (ready.load(std::memory_order_relaxed) != nullptr)
+        handBack(ready.exchange(nullptr, std::memory_order_acquire));
+
+    if (linesAskedFor != 0)
+    {
+        linesAskedFor = 0;
+        requestedLines.store(0, std::memory_order_release);
+    }
+
+    handBack(lines.release());
+}
+
+// What a cleared line would have given: a read whose sample is older than
+// the reset is 0, and one that interpolates towards such a sample fades
+// the first sample written since (at resetIndex) towards 0.
+void FeedbackDelayNetwork::silenceStaleReads(int row, int line, int offset, bool interpolate,
+                                             float* out, int numSamples) const noexcept
+{
+    const float* delay = delays.getReadPointer(line, offset);
+    const float first = lines->getReadPointer(row)[resetIndex];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int written = samplesSinceReset + i;
+        const int delayInt = (int)delay[i];
+
+        if (delayInt > written)
+            out[i] = 0.0f;
+        else if (delayInt == written && interpolate)
+            out[i] = first + (delay[i] - (float)delayInt) * (0.0f - first);
+    }
+}
+
+void FeedbackDelayNetwork::setNumLines(int newNumLines)
+{
+    jassert(newNumLines == 4 || newNumLines == 8 || newNumLines == 16);
+
+    if (newNumLines != numLines)
+    {
+        numLines = newNumLines;
+        reset();
+    }
+}
+
+void FeedbackDelayNetwork::process(const DspKernels& kernels, int channel, int offset, const float* input,
+                                   float feedback, bool interpolate, float* wet, int numSamples)
+{
+    if (lines == nullptr)
+    {
+        juce::FloatVectorOperations::clear(wet, numSamples);
+        return;
+    }
+
+    const int firstRow = channel * numLines;
+    const int lineLength = lines->getBufferLength();
+    const int writeIndex = lines->getWriteIndex();
+
+    float* out[maxLines];
+
+    for (int k = 0; k < numLines; ++k)
+    {
+        out[k] = lineOut.getWritePointer(k);
+        const float* tapDelays[] = { delays.getReadPointer(k, offset) };
+
+        kernels.readTaps(lines->getReadPointer(firstRow + k), lineLength, writeIndex,
+                         tapDelays, 1, numSamples, interpolate, 1.0f, out[k]);
+
+        if (samplesSinceReset < lineLength)
+            silenceStaleReads(firstRow + k, k, offset, interpolate, out[k], numSamples);
+    }
+
+    // Fast Walsh-Hadamard transform: log2 N passes of N / 2 butterflies.
+    // Unnormalised it scales by sqrt(N), which the gains below take out.
+    for (int span = 1; span < numLines; span *= 2)
+        for (int start = 0; start < numLines; start += 2 * span)
+            for (int k = start; k < start + span; ++k)
+                kernels.butterfly(out[k], out[k + span], numSamples);
+
+    const float norm = 1.0f / std::sqrt((float)numLines);
+
+    // Row 0 of the Hadamard matrix is all ones: the plain sum of the lines.
+    // 0.6 puts the cloud at about the level of the three-tap sum.
+    for (int i = 0; i < numSamples; ++i)
+        wet[i] = 0.6f * norm * out[0][i];
+
+    // All lines of the channel at once, they share the coefficients
+    if (damping.isActive())
+        damping.processRows(kernels, channel * maxLines, out, numLines, numSamples);
+
+    for (int k = 0; k < numLines; ++k)
+        kernels.writeFeedback(lines->getWritePointer(firstRow + k), lineLength, writeIndex,
+                              input, out[k], feedback * norm, numSamples);
+}
@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    FeedbackDelayNetwork.h
+    Created: 11 Apr 2026 6:55:20pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "JuceDelayLine.h"
+#include "DspKernels.h"
+#include "LoopDamping.h"
+#include <atomic>
+#include <limits>
+
+// The FDN engine: 4, 8 or 16 delay lines per channel whose outputs are mixed
+// through a normalised Hadamard matrix and fed back into all lines.
+//
+// Line k of N is T * ratio^(k / (N - 1)) long, so the lines are spread
+// geometrically between the base time T and T * ratio (TIME_F and TAP3, which
+// defaults to the golden ratio); the lengths share no common factor and the
+// echoes smear into a dense cloud.
+//
+// All lines of all channels live in one JuceDelayLine (numChannels * N
+// rows, one shared write index). Like the three-tap engine it works on
+// sub-blocks no longer than the shortest line: every line is read for the
+// whole sub-block with DspKernels::readTaps, the matrix is applied as a fast
+// Walsh-Hadamard transform (log2 N butterfly passes over contiguous sample
+// rows, DspKernels::butterfly) and the lines are written back with
+// DspKernels::writeFeedback.
+//
+// The lines only exist while an FDN engine is selected, sized for its N: at
+// 3600 ms each they would otherwise be the bulk of every instance's memory.
+// The audio thread can't allocate them, so a switch asks a background thread
+// shared by all instances to lay them out and swaps them in once they are
+// there (tens of milliseconds, the network is silent until then). Offline
+// (setNonRealtime) they are laid out on the spot, so renders are repeatable.
+//
+// reset() clears nothing: the rows are far too much memory to touch on the
+// audio thread. It marks the write index instead, and until the lines have
+// wrapped every read of a sample written before that mark comes out as
+// silence, exactly as if the rows had been cleared.
+class FeedbackDelayNetwork
+{
+public:
+    static constexpr int maxLines = 16;
+
+    FeedbackDelayNetwork();
+    ~FeedbackDelayNetwork();
+
+    // Lays out the lines for numLinesToAllocate (the engine about to run, 0
+    // for none); the rest are requested when an FDN engine is switched to.
+    void prepare(double sampleRate, float maxDelayMs, int numChannels, int maxBlockSize,
+                 int numLinesToAllocate);
+
+    // Starts from silent lines in constant time, see above.
+    void reset() noexcept;
+
+    // Frees the lines until the next prepare.
+    void release();
+
+    // Offline the lines are laid out on the audio thread itself.
+    void setNonRealtime(bool isNonRealtime) noexcept { nonRealtime = isNonRealtime; }
+
+    // Audio thread, once per chunk while an FDN engine runs: swaps in the
+    // lines for the current N or asks for them.
+    void acquireLines() noexcept;
+
+    // Audio thread, once per chunk under any other engine: hands the lines
+    // back to be freed.
+    void dropLines() noexcept;
+
+    // 4, 8 or 16. Changing it clears the lines.
+    void setNumLines(int newNumLines);
+    int getNumLines() const noexcept { return numLines; }
+
+    void setDamping(float highCutHz, float lowCutHz) noexcept { damping.setCutoffs(highCutHz, lowCutHz); }
+
+    // Fills the line delays of sample i of the next chunk. baseMs is line 0.
+    void setDelays(int i, float baseMs, float ratio) noexcept
+    {
+        const float step = std::pow(ratio, 1.0f / (float)(numLines - 1));
+        float multiplier = 1.0f;
+
+        for (int k = 0; k < numLines; ++k)
+        {
+            delays.setSample(k, i, getDelaySamples(baseMs * multiplier));
+            multiplier *= step;
+        }
+    }
+
+    // Shortest delay at sample i, for the sub-block limit.
+    float getMinDelay(int i) const noexcept { return delays.getSample(0, i); }
+
+    // Processes samples [offset, offset + numSamples) of the chunk for one
+    // channel: input goes into every line, wet receives the network output
+    // (silence while the lines aren't there).
+    void process(const DspKernels& kernels, int channel, int offset, const float* input,
+                 float feedback, bool interpolate, float* wet, int numSamples);
+
+    // After all channels of a sub-block.
+    void advance(int numSamples)
+    {
+        if (lines == nullptr)
+            return;
+
+        lines->advance(numSamples);
+        samplesSinceReset = juce::jmin(lines->getBufferLength(), samplesSinceReset + numSamples);
+    }
+
+    // Longest sub-block the ring can take in one write (no limit without lines).
+    int getLineLength() const noexcept
+    {
+        return lines != nullptr ? lines->getBufferLength() : std::numeric_limits<int>::max();
+    }
+
+private:
+    class Allocator;
+
+    // Same as JuceDelayLine::getDelaySamples, lines or not.
+    float getDelaySamples(float delayTimeMs) const noexcept
+    {
+        return juce::jlimit(0.0f, maxDelay, delayTimeMs) * 0.001f * (float)rate;
+    }
+
+    // Allocator's thread or the message thread, under the allocator's lock.
+    std::unique_ptr<JuceDelayLine> createLines(int linesPerChannel) const;
+    void serviceRequest();
+    void freeHandedBack();
+
+    // Audio thread: the allocator frees it on its next pass.
+    void handBack(JuceDelayLine* old) noexcept;
+    void swapIn(JuceDelayLine* newLines) noexcept;
+
+    juce::SharedResourcePointer<Allocator> allocator;
+
+    std::unique_ptr<JuceDelayLine> lines;  // row channel * numLines + k, null while not needed
+    LoopDamping damping;                   // one state column per line, row channel * maxLines + k
+    juce::AudioBuffer<float> delays;       // maxLines x block: delay of line k at sample i
+    juce::AudioBuffer<float> lineOut;      // maxLines x block: line outputs / mixed signals
+    int numLines = 4;
+    bool nonRealtime = false;
+
+    double rate = 44100.0;
+    float maxDelay = 1000.0f;
+    int channels = 0;
+
+    // Audio thread <-> allocator: the lines per channel wanted (0: none),
+    // lines laid out for that and lines handed back to be freed.
+    static constexpr int numHandBackSlots = 4;
+    std::atomic<int> requestedLines { 0 };
+    std::atomic<JuceDelayLine*> ready { nullptr };
+    std::atomic<JuceDelayLine*> handedBack[numHandBackSlots] {};
+    int linesAskedFor = 0;                 // audio thread's copy of its last request
+
+    // Where the lines were last reset and how much has been written since;
+    // at the buffer length everything older is overwritten.
+    int resetIndex = 0;
+    int samplesSinceReset = 0;
+
+    void silenceStaleReads(int row, int line, int offset, bool interpolate, float* out, int numSamples) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (FeedbackDelayNetwork)
+};
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    FilmstripLookAndFeel.cpp
+    Created: 2 Apr 2026 10:18:46pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "FilmstripLookAndFeel.h"
+#include <list>
+
+// Frames by knob look, most recently drawn first. Only touched from the
+// message thread, like all painting.
+//
+// Every editor size and display scale is a new look, so resizing would pile
+// up strips nobody draws again: past maxLooks the least recently drawn one
+// goes. The editor has 8 knobs; the bound leaves room for a few sizes of it.
+class FilmstripLookAndFeel::FrameCache
+{
+public:
+    static constexpr size_t maxLooks = 32;
+
+    // Frames are rendered on first use, so a knob nobody moves costs one frame.
+    juce::Array<juce::Image>& getStrip(const juce::String& key)
+    {
+        for (auto it = strips.begin(); it != strips.end(); ++it)
+        {
+            if (it->first == key)
+            {
+                strips.splice(strips.begin(), strips, it);
+                return it->second;
+            }
+        }
+
+        if (strips.size() >= maxLooks)
+            strips.pop_back();
+
+        strips.emplace_front(key, juce::Array<juce::Image>());
+        auto& strip = strips.front().second;
+        strip.resize(numFrames);
+
+        return strip;
+    }
+
+private:
+    std::list<std::pair<juce::String, juce::Array<juce::Image>>> strips;
+};
+
+FilmstripLookAndFeel::FilmstripLookAndFeel() = default;
+FilmstripLookAndFeel::~FilmstripLookAndFeel() = default;
+
+void FilmstripLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+                                            float sliderPosProportional, float rotaryStartAngle,
+                                            float rotaryEndAngle, juce::Slider& slider)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    // Everything the vector drawing depends on, apart from the position
+    const auto key = juce::String(width) + "x" + juce::String(height) + "@" + juce::String(scale, 3)
+                   + ":" + juce::String(rotaryStartAngle, 4) + ":" + juce::String(rotaryEndAngle, 4)
+                   + ":" + juce::String::toHexString((int)slider.findColour(juce::Slider::rotarySliderFillColourId).getARGB())
+                   + ":" + juce::String::toHexString((int)slider.findColour(juce::Slider::rotarySliderOutlineColourId).getARGB())
+                   + ":" + juce::String::toHexString((int)slider.findColour(juce::Slider::thumbColourId).getARGB())
+                   + (slider.isEnabled() ? "" : ":off");
+
+    const int frame = juce::jlimit(0, numFrames - 1, juce::roundToInt(sliderPosProportional * (float)(numFrames - 1)));
+    auto& image = cache->getStrip(key).getReference(frame);
+
+    if (image.isNull())
+    {
+        image = juce::Image(juce::Image::ARGB, juce::roundToInt((float)width * scale),
+                            juce::roundToInt((float)height * scale), true);
+
+        juce::Graphics frameGraphics(image);
+        frameGraphics.addTransform(juce::AffineTransform::scale(scale));
+        foleys::LookAndFeel::drawRotarySlider(frameGraphics, 0, 0, width, height,
+                                              (float)frame / (float)(numFrames - 1),
+                                              rotaryStartAngle, rotaryEndAngle, slider);
+    }
+
+    g.drawImage(image, juce::Rectangle<int>(x, y, width, height).toFloat());
+}
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    FilmstripLookAndFeel.h
+    Created: 2 Apr 2026 10:18:46pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// FoleysFinest with cached rotary sliders. Each knob look (size, display
+// scale, angles and colours) is drawn once per frame position by the normal
+// vector code into an image, and every later repaint just blits the frame.
+// The frames live in a process-wide cache shared by all open editors, keep
+// the most recently drawn looks and are dropped when the last editor closes.
+//
+// Registered as "FoleysFilmstrip" in MagicGUIAudioProcessor::initialiseBuilder.
+class FilmstripLookAndFeel : public foleys::LookAndFeel
+{
+public:
+    // Positions per knob; fine enough that a step is below a pixel at knob sizes.
+    static constexpr int numFrames = 128;
+
+    // Out of line: the cache is only complete in the .cpp.
+    FilmstripLookAndFeel();
+    ~FilmstripLookAndFeel() override;
+
+    void drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height,
+                           float sliderPosProportional, float rotaryStartAngle,
+                           float rotaryEndAngle, juce::Slider& slider) override;
+
+private:
+    class FrameCache;
+
+    juce::SharedResourcePointer<FrameCache> cache;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilmstripLookAndFeel)
+};
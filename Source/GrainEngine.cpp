@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    GrainEngine.cpp
+    Created: 17 Apr 2026 9:04:37pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "GrainEngine.h"
+
+namespace
+{
+    const float goldenRatio = 1.618034f;
+    const float sourceMultipliers[] = { 1.0f, goldenRatio, goldenRatio * goldenRatio };
+}
+
+GrainEngine::GrainEngine()
+{
+    // Hann, with the closing zero as the extra entry so age * step never overruns
+    for (int j = 0; j <= windowSize; ++j)
+        window[j] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float)j / (float)windowSize);
+}
+
+void GrainEngine::prepare(double sampleRate, int maxBlockSize)
+{
+    jassert(sampleRate > 0);
+    sr = sampleRate;
+    envelopes.setSize(maxGrains, juce::jmax(1, maxBlockSize), false, false, true);
+    curve.setSize(1, (int)std::ceil(maxGrainMs * 0.001 * sr) + 1, false, false, true);
+    curveLength = 0;
+    reset();
+}
+
+void GrainEngine::reset()
+{
+    for (auto& grain : grains)
+        grain = Grain();
+
+    samplesToOnset = 0.0;
+    random.setSeed(randomSeed);
+}
+
+void GrainEngine::setParameters(float grainSizeMs, float grainsPerSecond, int repeats) noexcept
+{
+    grainLength = juce::jlimit(16, curve.getNumSamples() - 1, juce::roundToInt(grainSizeMs * 0.001 * sr));
+    grainRepeats = juce::jmax(1, repeats);
+    onsetInterval = sr / (double)juce::jmax(0.1f, grainsPerSecond);
+
+    // About constant loudness however many grains overlap (Hann averages 0.5)
+    const float overlap = (float)((double)grainLength * grainRepeats / onsetInterval);
+    grainGain = 1.0f / std::sqrt(juce::jmax(1.0f, 0.5f * overlap));
+}
+
+void GrainEngine::schedule(const DspKernels& kernels, const float* baseDelay, int numSamples,
+                           int writeIndex, int lineLength) noexcept
+{
+    for (; samplesToOnset < (double)numSamples; samplesToOnset += onsetInterval)
+    {
+        const int offset = (int)samplesToOnset;
+
+        Grain* grain = nullptr;
+        for (auto& g : grains)
+        {
+            if (g.length == 0)
+            {
+                grain = &g;
+                break;
+            }
+        }
+
+        if (grain == nullptr)
+            continue;   // pool full: this onset is dropped
+
+        // Settings changed since the last grain: a new shared curve
+        if (curveLength != grainLength || curveGain != grainGain)
+        {
+            curveLength = grainLength;
+            curveGain = grainGain;
+            ++curveVersion;
+            kernels.grainEnvelope(window, 0, (float)windowSize / (float)(curveLength - 1), curveGain,
+                                  curve.getWritePointer(0), curveLength);
+        }
+
+        // Every pass must still find its source in the ring:
+        // gap + repeats * length stays below the line length.
+        const int length = juce::jmin(grainLength, (lineLength - 2) / (grainRepeats + 1));
+        const float multiplier = sourceMultipliers[random.nextInt(3)];
+        const int gap = juce::jlimit(1, lineLength - 1 - grainRepeats * length,
+                                     (int)(baseDelay[offset] * multiplier));
+
+        int readIndex = writeIndex + offset - gap;
+        if (readIndex < 0)
+            readIndex += lineLength;
+
+        grain->readIndex = readIndex;
+        grain->age = 0;
+        grain->length = length;
+        grain->repeatsLeft = grainRepeats - 1;
+        grain->startOffset = offset;
+        grain->windowStep = (float)windowSize / (float)juce::jmax(1, length - 1);
+        grain->gain = grainGain;
+        grain->curveVersion = length == curveLength ? curveVersion : -1;
+    }
+
+    samplesToOnset -= (double)numSamples;
+
+    // Envelopes of the grains left over from older settings, once for all
+    // channels. Ring position doesn't matter here, only where each pass starts over.
+    for (int g = 0; g < maxGrains; ++g)
+    {
+        const auto& grain = grains[g];
+        if (grain.length == 0 || isOnCurve(grain))
+            continue;
+
+        float* envelope = envelopes.getWritePointer(g);
+        int age = grain.age;
+        int repeatsLeft = grain.repeatsLeft;
+
+        for (int i = grain.startOffset; i < numSamples;)
+        {
+            const int run = juce::jmin(numSamples - i, grain.length - age);
+            kernels.grainEnvelope(window, age, grain.windowStep, grain.gain, envelope + i, run);
+
+            i += run;
+            age += run;
+
+            if (age == grain.length)
+            {
+                if (repeatsLeft-- == 0)
+                    break;
+                age = 0;
+            }
+        }
+    }
+}
+
+void GrainEngine::render(const float* line, int lineLength, float* out, int numSamples) const noexcept
+{
+    for (int g = 0; g < maxGrains; ++g)
+    {
+        const auto& grain = grains[g];
+        if (grain.length == 0)
+            continue;
+
+        const bool onCurve = isOnCurve(grain);
+        const float* envelope = envelopes.getReadPointer(g);
+
+        int readIndex = grain.readIndex;
+        int age = grain.age;
+        int repeatsLeft = grain.repeatsLeft;
+
+        for (int i = grain.startOffset; i < numSamples;)
+        {
+            // Up to the end of the pass or the ring, whichever comes first
+            const int run = juce::jmin(numSamples - i, grain.length - age, lineLength - readIndex);
+            juce::FloatVectorOperations::addWithMultiply(out + i, line + readIndex,
+                                                         onCurve ? curve.getReadPointer(0, age) : envelope + i, run);
+
+            i += run;
+            age += run;
+            readIndex += run;
+            if (readIndex == lineLength)
+                readIndex = 0;
+
+            if (age == grain.length)
+            {
+                if (repeatsLeft-- == 0)
+                    break;
+
+                // Stutter: back to the start of the stretch just played
+                age = 0;
+                readIndex -= grain.length;
+                if (readIndex < 0)
+                    readIndex += lineLength;
+            }
+        }
+    }
+}
+
+void GrainEngine::advance(int numSamples, int lineLength) noexcept
+{
+    for (auto& grain : grains)
+    {
+        if (grain.length == 0)
+            continue;
+
+        int remaining = numSamples - grain.startOffset;
+        grain.startOffset = 0;
+
+        while (remaining > 0)
+        {
+            const int run = juce::jmin(remaining, grain.length - grain.age);
+
+            remaining -= run;
+            grain.age += run;
+            grain.readIndex += run;
+            if (grain.readIndex >= lineLength)
+                grain.readIndex -= lineLength;
+
+            if (grain.age == grain.length)
+            {
+                if (grain.repeatsLeft == 0)
+                {
+                    grain.length = 0;   // back to the pool
+                    break;
+                }
+
+                --grain.repeatsLeft;
+                grain.age = 0;
+                grain.readIndex -= grain.length;
+                if (grain.readIndex < 0)
+                    grain.readIndex += lineLength;
+            }
+        }
+    }
+}
+
+int GrainEngine::getNumActiveGrains() const noexcept
+{
+    int count = 0;
+
+    for (const auto& grain : grains)
+        if (grain.length != 0)
+            ++count;
+
+    return count;
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    GrainEngine.h
+    Created: 17 Apr 2026 9:04:37pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+// The Glitch engine's stutter layer: short windowed grains read from the live
+// long delay line (the one the three taps keep feeding back into).
+//
+// A grain starts at a scheduled sample, picks a source point T, T * phi or
+// T * phi^2 behind the write head (the golden-ratio taps of the old glitch
+// version), plays grainSize samples under a Hann window and then jumps back
+// and plays the same stretch again, repeats times over: a stutter. The
+// source points come from a fixed-seed generator that reset() restarts, so
+// the same input renders the same stutter every time.
+//
+// Everything is fixed size: the grains come from a pool of maxGrains slots
+// (an onset with no free slot is dropped, which also caps the cost) and the
+// window is one precomputed table, so starting a grain costs a few stores.
+//
+// All grains started with the same size and gain share one envelope curve,
+// drawn from the window table (DspKernels::grainEnvelope) when a setting
+// changes, so render() costs one multiply-add per grain and sample for each
+// channel. Grains still playing from before a change get their envelope
+// redrawn per sub-block instead.
+//
+// Grain state is shared by all channels: render() reads each channel's line
+// without touching it and advance() moves the grains on once all channels
+// have been rendered, the same split as JuceDelayLine::advance.
+class GrainEngine
+{
+public:
+    static constexpr int maxGrains = 16;
+    static constexpr int windowSize = 1024;
+    static constexpr float maxGrainMs = 250.0f;
+
+    GrainEngine();
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // Once per chunk. Settings only apply to grains started afterwards.
+    void setParameters(float grainSizeMs, float grainsPerSecond, int repeats) noexcept;
+
+    // Starts the grains whose onsets fall in the next numSamples samples and
+    // draws the envelopes that aren't on the shared curve. baseDelay is the
+    // smoothed TIME_F curve of those samples, writeIndex the line's write
+    // index at the first of them.
+    void schedule(const DspKernels& kernels, const float* baseDelay, int numSamples,
+                  int writeIndex, int lineLength) noexcept;
+
+    // Adds the grains of one channel to out. The line must already hold the
+    // sub-block's own samples (grains may read as little as one sample back).
+    void render(const float* line, int lineLength, float* out, int numSamples) const noexcept;
+
+    // After all channels of a sub-block.
+    void advance(int numSamples, int lineLength) noexcept;
+
+    int getNumActiveGrains() const noexcept;
+
+private:
+    struct Grain
+    {
+        int   readIndex = 0;     // ring index of the next source sample
+        int   age = 0;           // samples played of the current pass
+        int   length = 0;        // 0: slot free
+        int   repeatsLeft = 0;   // passes after the current one
+        int   startOffset = 0;   // first sample of the sub-block it sounds in
+        float windowStep = 0.0f; // window table entries per sample
+        float gain = 0.0f;
+        int   curveVersion = -1;  // the shared curve it was started on
+    };
+
+    bool isOnCurve(const Grain& grain) const noexcept { return grain.curveVersion == curveVersion; }
+
+    Grain grains[maxGrains];
+    float window[windowSize + 1];
+    juce::AudioBuffer<float> curve;       // 1 x max grain: the current setting's envelope by age
+    juce::AudioBuffer<float> envelopes;   // maxGrains x block: off-curve grain g's envelope at sample i
+    int   curveLength = 0;
+    float curveGain = 0.0f;
+    int   curveVersion = 0;
+
+    static constexpr juce::int64 randomSeed = 0x4752414e;   // "GRAN"
+    juce::Random random { randomSeed };
+    double sr = 44100.0;
+
+    int   grainLength = 2048;     // samples
+    int   grainRepeats = 1;
+    float grainGain = 1.0f;
+    double onsetInterval = 4096.0; // samples between onsets
+    double samplesToOnset = 0.0;   // fractional, so the rhythm never drifts
+};
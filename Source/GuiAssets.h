@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    GuiAssets.h
+    Created: 24 Mar 2026 8:02:15pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// The decoded images of all BinaryData PNGs, shared by every editor in the
+// process. Hold it through a juce::SharedResourcePointer while an editor is
+// open: the first holder decodes, the rest share, and the images are dropped
+// when the last one lets go.
+//
+// Decoding goes through juce::ImageCache, keyed by the resource pointer, which
+// is also where foleys::Resources::getImage looks when magic.xml asks for a
+// background-image. While this object holds the images, the GUI's lookups
+// hit the cache instead of decoding their own copy.
+class GuiAssets
+{
+public:
+    GuiAssets()
+    {
+        for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
+        {
+            const juce::String name(BinaryData::namedResourceList[i]);
+            if (!name.endsWithIgnoreCase("_png"))
+                continue;
+
+            int size = 0;
+            if (const auto* data = BinaryData::getNamedResource(BinaryData::namedResourceList[i], size))
+                images.set(name, juce::ImageCache::getFromMemory(data, size));
+        }
+    }
+
+    juce::Image getImage(const juce::String& resourceName) const
+    {
+        return images[resourceName];
+    }
+
+private:
+    juce::HashMap<juce::String, juce::Image> images;
+
+    JUCE_DECLARE_NON_COPYABLE (GuiAssets)
+};
@@ -24,28 +24,64 @@ public:
     // - sampleRate: host sample rate
     // - maxDelayMs: maximum delay time in milliseconds
     // - numChannels: number of channels to store
-    void prepare(double sampleRate, float maxDelayMs, int numChannels)
+    // Hosts prepare again on every transport start or bounce: with the same
+    // rate, length and channels the buffer and its contents are kept as they
+    // are. Returns true if the line was laid out anew (and cleared).
+    bool prepare(double sampleRate, float maxDelayMs, int numChannels)
     {
         jassert(sampleRate > 0);
         jassert(maxDelayMs > 0);
         jassert(numChannels > 0);
 
-        sr = sampleRate;
+        const int fullLength = getLengthFor(sampleRate, maxDelayMs);
+
         maxDelay = maxDelayMs;
 
-        const int maxDelaySamples = (int)std::ceil(sr * maxDelay * 0.001f);
+        if (sampleRate == sr && fullLength == buffer.getNumSamples() && numChannels == buffer.getNumChannels())
+            return false;
+
+        sr = sampleRate;
 
-        buffer.setSize(numChannels, maxDelaySamples);
+        // Shrinking keeps the old allocation
+        buffer.setSize(numChannels, fullLength, false, false, true);
+        bufferLength = getLengthFor(getRate(), maxDelay);
         buffer.clear();
 
-        bufferLength = maxDelaySamples;
         writeIndex = 0;
+        return true;
     }
 
-    // Clear contents
+    // LOFI: runs the line at sampleRate / divisor (1, 2 or 4). Delays are then
+    // counted in samples of that rate and only that much of the buffer is
+    // used. Changing it clears the line.
+    void setRateDivisor(int divisor)
+    {
+        jassert(divisor >= 1);
+
+        if (divisor == rateDivisor)
+            return;
+
+        rateDivisor = divisor;
+        bufferLength = juce::jmin(buffer.getNumSamples(), getLengthFor(getRate(), maxDelay));
+        reset();
+    }
+
+    int getRateDivisor() const noexcept { return rateDivisor; }
+    double getRate() const noexcept { return sr / rateDivisor; }
+
+    // Frees the buffer while the host has the processor released. The next
+    // prepare lays the line out anew.
+    void release()
+    {
+        buffer.setSize(0, 0);
+        bufferLength = 0;
+        writeIndex = 0;
+    }
+
+    // Clear contents (the part in use)
     void reset()
     {
-        buffer.clear();
+        buffer.clear(0, bufferLength);
         writeIndex = 0;
     }
 
@@ -67,10 +103,7 @@ public:
         jassert(juce::isPositiveAndBelow(channel, buffer.getNumChannels()));
         jassert(bufferLength > 0);
 
-        // Clamp delay time to [0, maxDelay]
-        delayTimeMs = juce::jlimit(0.0f, maxDelay, delayTimeMs);
-
-        const float delaySamplesFloat = delayTimeMs * 0.001f * (float)sr;
+        const float delaySamplesFloat = getDelaySamples(delayTimeMs);
         const int   delaySamplesInt = (int)delaySamplesFloat;
 
         // Base read index (integer)
@@ -100,6 +133,16 @@ public:
         }
     }
 
+    // Delay time in ms -> (fractional) delay in samples, clamped to [0, maxDelay].
+    float getDelaySamples(float delayTimeMs) const noexcept
+    {
+        delayTimeMs = juce::jlimit(0.0f, maxDelay, delayTimeMs);
+        return delayTimeMs * 0.001f * (float)getRate();
+    }
+
+    // The longest delay getDelaySamples can return.
+    float getMaxDelaySamples() const noexcept { return getDelaySamples(maxDelay); }
+
     // Advance the write index by 1 sample (call once per processed sample).
     void advance()
     {
@@ -107,13 +150,37 @@ public:
             writeIndex = 0;
     }
 
+    // Advance by a whole block after it was written with the block kernels.
+    // The kernels never write more than bufferLength samples at once, but the
+    // index stays inside the ring whatever it is given.
+    void advance(int numSamples)
+    {
+        jassert(numSamples >= 0 && numSamples <= bufferLength);
+
+        if (bufferLength > 0)
+            writeIndex = (writeIndex + numSamples) % bufferLength;
+    }
+
     int getBufferLength() const noexcept { return bufferLength; }
     int getNumChannels() const noexcept { return buffer.getNumChannels(); }
+    int getWriteIndex() const noexcept { return writeIndex; }
+
+    // Raw ring buffer access for the block kernels in DspKernels.h
+    float* getWritePointer(int channel) noexcept { return buffer.getWritePointer(channel); }
+    const float* getReadPointer(int channel) const noexcept { return buffer.getReadPointer(channel); }
 
 private:
-    juce::AudioBuffer<float> buffer;
-    int    bufferLength = 0;
+    // +2: room for the interpolation neighbour at the maximum delay, so a
+    // read never lands on a slot written earlier in the same block.
+    static int getLengthFor(double rate, float maxDelayMs) noexcept
+    {
+        return (int)std::ceil(rate * maxDelayMs * 0.001f) + 2;
+    }
+
+    juce::AudioBuffer<float> buffer;   // allocated for the full rate
+    int    bufferLength = 0;           // in use at the current rate
     int    writeIndex = 0;
+    int    rateDivisor = 1;
     double sr = 44100.0;
     float  maxDelay = 1000.0f; // ms
 };
@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    LevelMeters.h
+    Created: 28 Mar 2026 4:47:33pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "DspKernels.h"
+
+// Peak and RMS of the input, the output and the signal coming back out of
+// each delay line (how hot the feedback loops run).
+//
+// The audio thread measures whole blocks with DspKernels::measureLevels and
+// accumulates privately; about 30 times a second it publishes the window
+// through atomics and starts a new one. The GUI only loads those atomics.
+// While no editor is open (setActive(false)) nothing is measured at all.
+class LevelMeters
+{
+public:
+    enum Meter
+    {
+        input = 0,
+        output,
+        shortLoop,
+        longLoop,
+        numMeters
+    };
+
+    struct Reading
+    {
+        float peak = 0.0f;
+        float rms = 0.0f;
+    };
+
+    static constexpr double publishRateHz = 30.0;
+
+    void prepare(double sampleRate) noexcept
+    {
+        jassert(sampleRate > 0);
+        samplesPerPublish = juce::jmax(1, juce::roundToInt(sampleRate / publishRateHz));
+        samplesSincePublish = 0;
+
+        for (auto& a : accumulators)
+            a = {};
+    }
+
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive, std::memory_order_relaxed); }
+    bool isActive() const noexcept               { return active.load(std::memory_order_relaxed); }
+
+    // Audio thread: adds numSamples samples of one channel to the window.
+    void measure(const DspKernels& kernels, Meter meter, const float* data, int numSamples) noexcept
+    {
+        auto& a = accumulators[meter];
+        kernels.measureLevels(data, numSamples, a.peak, a.sumSquares);
+        a.numSamples += numSamples;
+    }
+
+    // Audio thread, once per block after all measure() calls.
+    void endBlock(int numSamples) noexcept
+    {
+        samplesSincePublish += numSamples;
+        if (samplesSincePublish < samplesPerPublish)
+            return;
+
+        for (int m = 0; m < numMeters; ++m)
+        {
+            auto& a = accumulators[m];
+            published[m].peak.store(a.peak, std::memory_order_relaxed);
+            published[m].rms.store(a.numSamples > 0 ? std::sqrt(a.sumSquares / (float)a.numSamples) : 0.0f,
+                                   std::memory_order_relaxed);
+            a = {};
+        }
+
+        samplesSincePublish = 0;
+    }
+
+    // Any thread: the last published window.
+    Reading getReading(Meter meter) const noexcept
+    {
+        return { published[meter].peak.load(std::memory_order_relaxed),
+                 published[meter].rms.load(std::memory_order_relaxed) };
+    }
+
+    static const char* getName(Meter meter) noexcept
+    {
+        static const char* const names[] = { "input", "output", "short", "long" };
+        return names[meter];
+    }
+
+private:
+    struct Accumulator
+    {
+        float peak = 0.0f;
+        float sumSquares = 0.0f;
+        int   numSamples = 0;
+    };
+
+    struct Published
+    {
+        std::atomic<float> peak { 0.0f };
+        std::atomic<float> rms { 0.0f };
+    };
+
+    Accumulator accumulators[numMeters];
+    Published published[numMeters];
+    int samplesPerPublish = 1600;
+    int samplesSincePublish = 0;
+    std::atomic<bool> active { false };
+};
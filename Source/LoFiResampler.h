@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    LoFiResampler.h
+    Created: 30 Apr 2026 9:26:51pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+#include <vector>
+
+// The rate changes of the LOFI mode, where the long line's loop runs at half
+// or a quarter of the sample rate: its input is decimated on the way in and
+// its wet output interpolated back up.
+//
+// Each factor of 2 is a polyphase IIR half-band filter: two chains of three
+// first-order allpasses, both running at the lower rate (de Soras' HIIR
+// structure). Six coefficients give a flat passband up to 0.2 fs and about
+// 80 dB of rejection above 0.3 fs, for three multiply-adds per full-rate
+// sample and stage. A quarter is two stages in a row.
+//
+// The allpass recurrences are serial, so channels go through in pairs: both
+// paths of both channels are the four lanes of one DspKernels halfBand step.
+// A channel without a partner fills both halves of its pair.
+//
+// Chunks don't have to be multiples of the factor: a decimator keeps the odd
+// sample for the next call, and the interpolator's output runs factor - 1
+// samples behind (its fixed latency) so there is always enough of it. The
+// phase is shared by all channels; advance() once decimate and interpolate
+// are done with a chunk.
+class LoFiResampler
+{
+public:
+    static constexpr int maxFactor = 4;
+
+    void prepare(int numChannels, int maxBlockSize)
+    {
+        pairs.assign((size_t)(juce::jmax(1, numChannels) + 1) / 2, Pair());
+
+        const size_t length = (size_t)(juce::jmax(1, maxBlockSize) + 2 * maxFactor);
+        for (int side = 0; side < 2; ++side)
+        {
+            work[side].assign(length, 0.0f);
+            half[side].assign(length / 2 + 1, 0.0f);
+        }
+
+        reset();
+    }
+
+    // 1, 2 or 4. Changing it clears the filters.
+    void setFactor(int newFactor) noexcept
+    {
+        jassert(newFactor == 1 || newFactor == 2 || newFactor == maxFactor);
+
+        if (newFactor != factor)
+        {
+            factor = newFactor;
+            reset();
+        }
+    }
+
+    int getFactor() const noexcept { return factor; }
+
+    void reset() noexcept
+    {
+        for (auto& pair : pairs)
+            pair = Pair();
+
+        phase = 0;
+    }
+
+    // How many low-rate samples the next numSamples make, and the index of
+    // the full-rate sample the first of them lines up with.
+    int getNumReduced(int numSamples) const noexcept { return (phase + numSamples) / factor; }
+    int getFirstIndex() const noexcept               { return factor - 1 - phase; }
+
+    // In place: numSamples in, getNumReduced(numSamples) out, per channel.
+    void decimate(const DspKernels& kernels, float* const* data, int numChannels, int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ch += 2)
+        {
+            auto& pair = pairs[(size_t)ch / 2];
+            float* a = data[ch];
+            float* b = data[juce::jmin(ch + 1, numChannels - 1)];
+
+            const int count = pair.down[0].decimate(kernels, a, b, numSamples, (phase & 1) != 0);
+
+            if (factor == maxFactor)
+                pair.down[1].decimate(kernels, a, b, count, (phase & 2) != 0);
+        }
+    }
+
+    // getNumReduced(numSamples) low-rate samples in, numSamples out, per
+    // channel. reduced and out may be the same buffers.
+    void interpolate(const DspKernels& kernels, const float* const* reduced, float* const* out,
+                     int numChannels, int numSamples) noexcept
+    {
+        const int carried = factor - 1 - phase;
+
+        for (int ch = 0; ch < numChannels; ch += 2)
+        {
+            auto& pair = pairs[(size_t)ch / 2];
+            const int other = juce::jmin(ch + 1, numChannels - 1);
+            const float* a = reduced[ch];
+            const float* b = reduced[other];
+            int count = getNumReduced(numSamples);
+
+            // Up into work, after what the last call had left over
+            for (int side = 0; side < 2; ++side)
+                std::copy(pair.carry[side], pair.carry[side] + carried, work[side].data());
+
+            if (factor == maxFactor)
+            {
+                pair.up[1].interpolate(kernels, a, b, half[0].data(), half[1].data(), count);
+                a = half[0].data();
+                b = half[1].data();
+                count *= 2;
+            }
+
+            pair.up[0].interpolate(kernels, a, b, work[0].data() + carried, work[1].data() + carried, count);
+
+            const int total = carried + 2 * count;
+            jassert(total >= numSamples && total - numSamples < maxFactor);
+
+            for (int side = 0; side < 2; ++side)
+            {
+                std::copy(work[side].data(), work[side].data() + numSamples, out[side == 0 ? ch : other]);
+                std::copy(work[side].data() + numSamples, work[side].data() + total, pair.carry[side]);
+            }
+        }
+    }
+
+    // After all channels.
+    void advance(int numSamples) noexcept { phase = (phase + numSamples) % factor; }
+
+private:
+    static constexpr int numStages = DspKernels::halfBandStages;
+
+    // Transition band 0.05 fs: 0.06029739096, 0.2159714446, 0.4125907204,
+    // 0.6043586265, 0.7727156537, 0.9238861387, the even ones in the first
+    // path and the odd ones in the second, laid out per lane.
+    static constexpr float coefficients[numStages * 4] = {
+        0.06029739096f, 0.2159714446f, 0.06029739096f, 0.2159714446f,
+        0.4125907204f,  0.6043586265f, 0.4125907204f,  0.6043586265f,
+        0.7727156537f,  0.9238861387f, 0.7727156537f,  0.9238861387f
+    };
+
+    struct HalfBand
+    {
+        float state[2 * numStages * 4] = {};   // allpass inputs, then outputs
+        float pending[2] = {};                 // decimator: each channel's odd sample left from the last call
+
+        // In place on both channels, returns the number of samples out. An
+        // odd sample left over waits in pending for the next call.
+        int decimate(const DspKernels& kernels, float* a, float* b, int numSamples, bool hasPending) noexcept
+        {
+            int used = 0;
+
+            if (hasPending && numSamples > 0)
+            {
+                float pairA[] = { pending[0], a[0] };
+                float pairB[] = { pending[1], b[0] };
+                kernels.halfBandDecimate(state, coefficients, pairA, pairB, 1);
+                a[0] = pairA[0];
+                b[0] = pairB[0];
+                used = 1;
+            }
+
+            // The outputs land right after the one above
+            const int numPairs = (numSamples - used) / 2;
+            kernels.halfBandDecimate(state, coefficients, a + used, b + used, numPairs);
+
+            if (used + 2 * numPairs < numSamples)
+            {
+                pending[0] = a[numSamples - 1];
+                pending[1] = b[numSamples - 1];
+            }
+
+            return used + numPairs;
+        }
+
+        void interpolate(const DspKernels& kernels, const float* inA, const float* inB,
+                         float* outA, float* outB, int numSamples) noexcept
+        {
+            kernels.halfBandInterpolate(state, coefficients, inA, inB, outA, outB, numSamples);
+        }
+    };
+
+    struct Pair
+    {
+        HalfBand down[2];                 // full -> half, half -> quarter
+        HalfBand up[2];                   // half -> full, quarter -> half
+        float carry[2][maxFactor] = {};   // interpolated, not yet handed out
+    };
+
+    std::vector<Pair> pairs;
+    std::vector<float> work[2];
+    std::vector<float> half[2];
+    int factor = 1;
+    int phase = 0;   // full-rate samples into the current low-rate one
+};
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    LoopDamping.h
+    Created: 6 Apr 2026 7:12:09pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+// High-cut and low-cut damping for a feedback loop: a TPT one-pole lowpass
+// followed by a TPT one-pole highpass, so every repeat is a little darker
+// and thinner than the one before.
+//
+// The filter state of all channels is kept structure-of-arrays (one row per
+// state variable, one column per channel) and each call filters a whole block
+// of one channel, or of several channels side by side (processRows, for the
+// FDN's lines, which all share the same coefficients). A cutoff at the end of its range switches that filter off
+// entirely, so the default settings cost nothing and change nothing.
+class LoopDamping
+{
+public:
+    static constexpr float highCutOffHz = 20000.0f;   // at or above: no high cut
+    static constexpr float lowCutOffHz = 20.0f;       // at or below: no low cut
+
+    // Keeps the filter state when nothing changed, like JuceDelayLine::prepare.
+    void prepare(double sampleRate, int numChannels)
+    {
+        jassert(sampleRate > 0);
+        numChannels = juce::jmax(1, numChannels);
+
+        if (sampleRate == sr && numChannels == state.getNumSamples())
+            return;
+
+        sr = sampleRate;
+        state.setSize(numStateRows, numChannels, false, false, true);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        state.clear();
+    }
+
+    // Once per chunk; cheap enough that automation needs no extra smoothing.
+    // rateDivisor: the loop runs at sampleRate / rateDivisor (LOFI).
+    void setCutoffs(float highCutHz, float lowCutHz, int rateDivisor = 1) noexcept
+    {
+        const double rate = sr / juce::jmax(1, rateDivisor);
+        const float nyquistGuard = 0.49f * (float)rate;
+
+        highCutOn = highCutHz < highCutOffHz && highCutHz < nyquistGuard;
+        lowCutOn = lowCutHz > lowCutOffHz;
+
+        if (highCutOn)
+            gHigh = coefficient(highCutHz, rate);
+        if (lowCutOn)
+            gLow = coefficient(juce::jmin(lowCutHz, nyquistGuard), rate);
+    }
+
+    bool isActive() const noexcept { return highCutOn || lowCutOn; }
+
+    // out may be the same as in.
+    void process(int channel, const float* in, float* out, int numSamples) noexcept
+    {
+        float lowpass = state.getSample(lowpassRow, channel);
+        float highpass = state.getSample(highpassRow, channel);
+        const float gh = gHigh, gl = gLow;
+
+        if (highCutOn && lowCutOn)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float lp = tick(in[i], lowpass, gh);
+                out[i] = lp - tick(lp, highpass, gl);
+            }
+        }
+        else if (highCutOn)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = tick(in[i], lowpass, gh);
+        }
+        else if (lowCutOn)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = in[i] - tick(in[i], highpass, gl);
+        }
+        else if (out != in)
+        {
+            juce::FloatVectorOperations::copy(out, in, numSamples);
+        }
+
+        state.setSample(lowpassRow, channel, lowpass);
+        state.setSample(highpassRow, channel, highpass);
+    }
+
+    // Channels firstChannel .. firstChannel + numRows - 1 at once, rows[r]
+    // in place, through DspKernels::dampRows.
+    void processRows(const DspKernels& kernels, int firstChannel, float* const* rows,
+                     int numRows, int numSamples) noexcept
+    {
+        jassert(firstChannel + numRows <= state.getNumSamples());
+
+        kernels.dampRows(rows, numRows, numSamples,
+                         state.getWritePointer(lowpassRow, firstChannel),
+                         state.getWritePointer(highpassRow, firstChannel),
+                         gHigh, gLow, highCutOn, lowCutOn);
+    }
+
+private:
+    enum StateRow
+    {
+        lowpassRow = 0,     // integrator of the high-cut lowpass
+        highpassRow,        // integrator of the lowpass the low cut subtracts
+        numStateRows
+    };
+
+    static float coefficient(float cutoffHz, double rate) noexcept
+    {
+        const float g = std::tan(juce::MathConstants<float>::pi * cutoffHz / (float)rate);
+        return g / (1.0f + g);
+    }
+
+    // One TPT one-pole lowpass step (Zavalishin), s is the integrator state.
+    static inline float tick(float x, float& s, float G) noexcept
+    {
+        const float v = (x - s) * G;
+        const float y = v + s;
+        s = y + v;
+        return y;
+    }
+
+    juce::AudioBuffer<float> state;
+    double sr = 44100.0;
+    float gHigh = 0.0f, gLow = 0.0f;
+    bool highCutOn = false, lowCutOn = false;
+};
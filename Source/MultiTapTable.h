@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    MultiTapTable.h
+    Created: 14 Apr 2026 8:21:43pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// The tap table of the Multi Tap engine: up to 16 taps on delayLine_f, each
+// with a time ratio (to TIME_F), an output gain, a pan and a feedback send.
+//
+// The table is refreshed from the parameters once per chunk and flattened into
+// the contiguous arrays DspKernels::multiTap takes: one ratio row, one send
+// row and one wet gain row per output channel with the pan already folded in.
+// The audio then only pays for the gathers.
+class MultiTapTable
+{
+public:
+    static constexpr int maxTaps = 16;
+    static constexpr float minRatio = 0.1f;
+    static constexpr float maxRatio = 3.0f;
+
+    // "TAP<n>_TIME", "TAP<n>_GAIN", "TAP<n>_PAN" or "TAP<n>_SEND", n counted from 1.
+    static juce::String getParameterID(int tap, const char* field)
+    {
+        return "TAP" + juce::String(tap + 1) + "_" + field;
+    }
+
+    struct Tap
+    {
+        float ratio = 1.0f;
+        float gain = 1.0f;
+        float pan = 0.0f;     // -1 left .. 1 right
+        float send = 1.0f;    // into the feedback loop
+    };
+
+    // Once per chunk. Pan is constant power between channels 0 and 1 and
+    // unity in the centre; mono and any further channels ignore it.
+    void update(const Tap* newTaps, int newNumTaps, int numChannels) noexcept
+    {
+        numTaps = juce::jlimit(1, maxTaps, newNumTaps);
+
+        // The sums are scaled so a fuller table is about as loud, and as
+        // stable in feedback, as the three fixed taps.
+        const float wetNorm = 1.0f / std::sqrt((float)numTaps);
+        const float sendNorm = 1.0f / (float)numTaps;
+        const bool stereo = numChannels > 1;
+
+        smallestRatio = maxRatio;
+
+        for (int t = 0; t < numTaps; ++t)
+        {
+            const auto& tap = newTaps[t];
+            const float gain = tap.gain * wetNorm;
+
+            ratios[t] = juce::jlimit(minRatio, maxRatio, tap.ratio);
+            sends[t] = tap.send * sendNorm;
+            smallestRatio = juce::jmin(smallestRatio, ratios[t]);
+
+            if (stereo)
+            {
+                const float angle = (juce::jlimit(-1.0f, 1.0f, tap.pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+                wetGains[leftRow][t] = gain * juce::MathConstants<float>::sqrt2 * std::cos(angle);
+                wetGains[rightRow][t] = gain * juce::MathConstants<float>::sqrt2 * std::sin(angle);
+            }
+            else
+            {
+                wetGains[leftRow][t] = gain;
+                wetGains[rightRow][t] = gain;
+            }
+
+            wetGains[centreRow][t] = gain;
+        }
+    }
+
+    int getNumTaps() const noexcept { return numTaps; }
+
+    // The shortest tap, for the sub-block limit.
+    float getSmallestRatio() const noexcept { return smallestRatio; }
+
+    const float* getRatios() const noexcept { return ratios; }
+    const float* getSendGains() const noexcept { return sends; }
+
+    const float* getWetGains(int channel) const noexcept
+    {
+        return wetGains[channel == 0 ? leftRow : (channel == 1 ? rightRow : centreRow)];
+    }
+
+private:
+    enum GainRow
+    {
+        leftRow = 0,
+        rightRow,
+        centreRow,
+        numGainRows
+    };
+
+    float ratios[maxTaps] = {};
+    float sends[maxTaps] = {};
+    float wetGains[numGainRows][maxTaps] = {};
+    float smallestRatio = 1.0f;
+    int numTaps = 1;
+};
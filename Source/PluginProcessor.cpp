@@ -7,47 +7,17 @@
 */
 
 #include "PluginProcessor.h"
+#include "RealtimeSafety.h"
+#include "PluginState.h"
+#include "FilmstripLookAndFeel.h"
 #include <cmath>
 
-namespace
-{
-    // Feedback block: how the old delay sample is fed back
-    inline float applyFeedback(float previousDelaySample, float feedbackAmount)
-    {
-        return previousDelaySample * feedbackAmount;
-    }
-
-    // Mix block: blend dry and wet
-    inline float applyMix(float dry, float wet, float mixAmount)
-    {
-        return dry * (1.0f - mixAmount) + wet * mixAmount;
-    }
-
-    inline float softClipTanh(float x)
-    {
-        // Simple soft clip: smooth around 1, no hard edge
-        return std::tanh(x);
-    }
-
-    // Gain block: final output gain
-    inline float applyGain(float sample, float gain)
-    {
-        // 1) Apply gain
-        float y = sample * gain;
-
-        // 2) Soft-clip with tanh
-        y = softClipTanh(y);
-
-        return y;
-    }
-}
-
 //==============================================================================
 MagicGUIAudioProcessor::MagicGUIAudioProcessor():MagicProcessor(),
     apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
             FOLEYS_SET_SOURCE_PATH (__FILE__);
-            magicState.setGuiValueTree(BinaryData::magic_xml, BinaryData::magic_xmlSize);
+            // magic.xml is parsed in createEditor, headless instances never need it
 
             bypassParam = apvts.getRawParameterValue("BYPASS");
             interpolateParam = apvts.getRawParameterValue("INTERPOLATION");
@@ -57,6 +27,32 @@ MagicGUIAudioProcessor::MagicGUIAudioProcessor():MagicProcessor(),
             mixParam = apvts.getRawParameterValue("MIX");
             gainParam = apvts.getRawParameterValue("GAIN");
             tap3Param = apvts.getRawParameterValue("TAP3");
+            dampHighParam = apvts.getRawParameterValue("DAMP_HI");
+            dampLowParam = apvts.getRawParameterValue("DAMP_LO");
+            engineParam = apvts.getRawParameterValue("ENGINE");
+            numTapsParam = apvts.getRawParameterValue("NUM_TAPS");
+            grainSizeParam = apvts.getRawParameterValue("GRAIN_SIZE");
+            grainDensityParam = apvts.getRawParameterValue("GRAIN_DENSITY");
+            grainRepeatParam = apvts.getRawParameterValue("GRAIN_REPEAT");
+            crossFeedParam = apvts.getRawParameterValue("XFEED");
+            crossWidthParam = apvts.getRawParameterValue("XFEED_WIDTH");
+            timeModeParam = apvts.getRawParameterValue("TIME_MODE");
+            crossfadeMsParam = apvts.getRawParameterValue("XFADE_MS");
+            loFiParam = apvts.getRawParameterValue("LOFI");
+
+            for (int t = 0; t < MultiTapTable::maxTaps; ++t)
+            {
+                tapParams[t].time = apvts.getRawParameterValue(MultiTapTable::getParameterID(t, "TIME"));
+                tapParams[t].gain = apvts.getRawParameterValue(MultiTapTable::getParameterID(t, "GAIN"));
+                tapParams[t].pan = apvts.getRawParameterValue(MultiTapTable::getParameterID(t, "PAN"));
+                tapParams[t].send = apvts.getRawParameterValue(MultiTapTable::getParameterID(t, "SEND"));
+            }
+
+           #if JECHO_TRACING
+            traceBuffer = traceRecorder->createBuffer();
+            if (traceBuffer != nullptr)
+                traceBuffer->watchParameters(apvts, PluginState::getParameterIDs());
+           #endif
             //timeParam = apvts.getRawParameterValue("TIME");
 }
 
@@ -74,9 +70,9 @@ MagicGUIAudioProcessor::createParameterLayout()
     //"TIME", "Time", juce::NormalisableRange<float>(1.0f, 2000.0f, 20.0f), 50.0f)); // ms
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        "TIME_S", "Time_S", juce::NormalisableRange<float>(0.0f, 200, 0.1f), 0.0f)); // ms
+        "TIME_S", "Time_S", juce::NormalisableRange<float>(0.0f, EchoEngine::maxShortTimeMs, 0.1f), 0.0f)); // ms
 
-    juce::NormalisableRange<float> timeRange{ 1.0f, 1200.0f, 0.0f, 0.5f };
+    juce::NormalisableRange<float> timeRange{ 1.0f, EchoEngine::maxLongTimeMs, 0.0f, 0.5f };
     //                        start  end     interval  skew
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "TIME_F", "Time_F",
@@ -85,7 +81,7 @@ MagicGUIAudioProcessor::createParameterLayout()
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "TAP3", "Tap3 Multiplier",
-        juce::NormalisableRange<float>(1.0f, 3.0f, 0.01f),
+        juce::NormalisableRange<float>(1.0f, EchoEngine::maxTap3, 0.01f),
         1.618f));  // default = golden ratio
 
     //params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -111,6 +107,93 @@ MagicGUIAudioProcessor::createParameterLayout()
         "INTERPOLATION", "Interpolation",
         false));
 
+    // Feedback damping, the defaults switch the filters off
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "DAMP_HI", "High Cut",
+        juce::NormalisableRange<float>(1000.0f, LoopDamping::highCutOffHz, 1.0f, 0.3f),
+        LoopDamping::highCutOffHz)); // Hz
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "DAMP_LO", "Low Cut",
+        juce::NormalisableRange<float>(LoopDamping::lowCutOffHz, 1000.0f, 1.0f, 0.4f),
+        LoopDamping::lowCutOffHz)); // Hz
+
+    // Triple Tap is the original engine; the FDN modes spread 4/8/16 lines
+    // between TIME_F and TIME_F * TAP3; Multi Tap reads the tap table below,
+    // Glitch adds stutter grains to the three taps.
+    // New engines are appended so saved indices keep their meaning.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "ENGINE", "Engine",
+        juce::StringArray{ "Triple Tap", "FDN 4", "FDN 8", "FDN 16", "Multi Tap", "Glitch" },
+        0));
+
+    // Multi Tap table. Tap times are ratios of TIME_F; by default the taps
+    // are spread evenly up to 3x, alternate left/right and all feed back.
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "NUM_TAPS", "Taps", 1, MultiTapTable::maxTaps, 8));
+
+    for (int t = 0; t < MultiTapTable::maxTaps; ++t)
+    {
+        const juce::String name = "Tap " + juce::String(t + 1) + " ";
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            MultiTapTable::getParameterID(t, "TIME"), name + "Time",
+            juce::NormalisableRange<float>(MultiTapTable::minRatio, MultiTapTable::maxRatio, 0.001f),
+            MultiTapTable::maxRatio * (float)(t + 1) / (float)MultiTapTable::maxTaps));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            MultiTapTable::getParameterID(t, "GAIN"), name + "Gain",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            MultiTapTable::getParameterID(t, "PAN"), name + "Pan",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), (t % 2 == 0) ? -0.5f : 0.5f));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            MultiTapTable::getParameterID(t, "SEND"), name + "Feedback Send",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+    }
+
+    // Glitch grains: length, onsets per second and how often each is played
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "GRAIN_SIZE", "Grain Size",
+        juce::NormalisableRange<float>(10.0f, GrainEngine::maxGrainMs, 1.0f, 0.5f), 60.0f)); // ms
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "GRAIN_DENSITY", "Grain Density",
+        juce::NormalisableRange<float>(1.0f, 40.0f, 0.1f, 0.5f), 12.0f)); // grains/s
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "GRAIN_REPEAT", "Grain Repeats", 1, 8, 3));
+
+    // Long-line feedback between channels; Off keeps every channel to itself
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "XFEED", "Cross Feedback",
+        juce::StringArray{ "Off", "Ping-Pong", "Spread", "Rotate" },
+        CrossFeedbackMatrix::off));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "XFEED_WIDTH", "Cross Width",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+
+    // How the three long-line taps follow TIME_F / TAP3 changes: a pitch
+    // glide (smoothed time) or a crossfade between the old and new time
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "TIME_MODE", "Time Change",
+        juce::StringArray{ "Glide", "Crossfade" },
+        0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "XFADE_MS", "Crossfade Time",
+        juce::NormalisableRange<float>(5.0f, 500.0f, 1.0f, 0.5f), 50.0f)); // ms
+
+    // Runs the long line at half or a quarter of the sample rate: darker,
+    // aliasing-free repeats for less work. Triple Tap and Multi Tap only.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "LOFI", "Lo-Fi",
+        juce::StringArray{ "Off", "1/2", "1/4" },
+        0));
+
     return { params.begin(), params.end() };
 }
 
@@ -127,162 +210,185 @@ double MagicGUIAudioProcessor::getTailLengthSeconds() const
     return 0.0;
 }
 
+//==============================================================================
+juce::AudioProcessorEditor* MagicGUIAudioProcessor::createEditor()
+{
+    // Only measure while somebody can actually see the numbers
+   #if JECHO_INSTRUMENTATION
+    loadMeter.setActive(true);
+   #endif
+    engine.getLevelMeters().setActive(true);
+    startTimerHz((int)LevelMeters::publishRateHz);
+
+    if (!guiTreeLoaded)
+    {
+        magicState.setGuiValueTree(BinaryData::magic_xml, BinaryData::magic_xmlSize);
+        guiTreeLoaded = true;
+    }
+
+    // Decodes the PNGs once per process, before the GUI asks for them
+    guiAssets.emplace();
 
+    return foleys::MagicProcessor::createEditor();
+}
 
-//==============================================================================
-void MagicGUIAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+void MagicGUIAudioProcessor::initialiseBuilder(foleys::MagicGUIBuilder& builder)
 {
+    foleys::MagicProcessor::initialiseBuilder(builder);
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = (juce::uint32)samplesPerBlock;
-    spec.numChannels = (juce::uint32)getTotalNumOutputChannels();
-
-    const float maxDelayMs_s = 200.0f;
-    const float maxDelayMs_f = 4000.0f;//The far higher due to the extra taps move range
-    delayLine_s.prepare(sampleRate, maxDelayMs_s, getTotalNumOutputChannels());
-    delayLine_f.prepare(sampleRate, maxDelayMs_f, getTotalNumOutputChannels());
-    // Time smoothing: 0.05 seconds (50 ms) ramp time is a nice starting point
-    timeMsSmoothed_s.reset(sampleRate, 0.10); // rampTimeSeconds
-    timeMsSmoothed_f.reset(sampleRate, 0.10); // rampTimeSeconds
-    tap3Smoothed.reset(sampleRate, 0.10f); // 10 ms ramp, same as time
-    // Start the smoothed value at the current parameter value
-    timeMsSmoothed_s.setCurrentAndTargetValue(timeParam_s->load());
-    timeMsSmoothed_f.setCurrentAndTargetValue(timeParam_f->load());
-    tap3Smoothed.setCurrentAndTargetValue(tap3Param->load());
+    // magic.xml uses this instead of FoleysFinest: same look, knobs drawn from cached frames
+    builder.registerLookAndFeel("FoleysFilmstrip", std::make_unique<FilmstripLookAndFeel>());
 }
 
-void MagicGUIAudioProcessor::releaseResources()
+void MagicGUIAudioProcessor::editorBeingDeleted(juce::AudioProcessorEditor* editor) noexcept
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    stopTimer();
+    engine.getLevelMeters().setActive(false);
+   #if JECHO_INSTRUMENTATION
+    loadMeter.setActive(false);
+   #endif
+
+    foleys::MagicProcessor::editorBeingDeleted(editor);
+    guiAssets.reset();
 }
 
-void MagicGUIAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
-    juce::MidiBuffer& midiMessages)
+void MagicGUIAudioProcessor::timerCallback()
 {
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    // Levels in dBFS, e.g. <Label value="meter:long:rms"/> for the feedback loop
+    for (int m = 0; m < LevelMeters::numMeters; ++m)
+    {
+        const auto meter = (LevelMeters::Meter)m;
+        const auto reading = engine.getLevelMeters().getReading(meter);
+        const juce::String prefix = juce::String("meter:") + LevelMeters::getName(meter);
 
-    const int numSamples = buffer.getNumSamples();
+        magicState.getPropertyAsValue(prefix + ":peak").setValue(juce::Decibels::gainToDecibels(reading.peak));
+        magicState.getPropertyAsValue(prefix + ":rms").setValue(juce::Decibels::gainToDecibels(reading.rms));
+    }
 
-    // Clear any extra output channels
-    for (auto ch = totalNumInputChannels; ch < totalNumOutputChannels; ++ch)
-        buffer.clear(ch, 0, numSamples);
+    // The load statistics need a longer window, about twice a second is enough
+    if (++timerTicks < (int)LevelMeters::publishRateHz / 2)
+        return;
 
-    // ===== Bypass =====
-    bool lastBypassState = false;
-    bool bypass = (bypassParam->load() < 0.5f);
+    timerTicks = 0;
 
-    if (bypass != lastBypassState)
-    {
-		// effect just turned OFF/just turned ON
-		delayLine_f.reset();
-        delayLine_s.reset();
-        lastBypassState = bypass;
-    }
+   #if JECHO_INSTRUMENTATION
+    // Fraction of the block duration spent in processBlock, in percent.
+    // Shown in magic.xml through e.g. <Label value="load:p99"/>.
+    const auto stats = loadMeter.collectStats();
 
-    // now do the actual bypass logic
-    if (bypass)
+    if (stats.numBlocks > 0)
     {
-        return;    // no processing
+        magicState.getPropertyAsValue("load:p50").setValue(100.0f * stats.p50);
+        magicState.getPropertyAsValue("load:p99").setValue(100.0f * stats.p99);
+        magicState.getPropertyAsValue("load:max").setValue(100.0f * stats.max);
     }
+   #endif
+}
 
-    // ===== Parameter block (read once per block) =====
-    const float timeMsTarget_s = timeParam_s->load();       // base delay time in ms
-    const float timeMsTarget_f = timeParam_f->load();       // base delay time in ms
-    const float feedback_s = 0.9;//hard setting for first delay line
-    const float feedback_f = feedbackParam->load();   // 0..0.95
-    const float mix = mixParam->load();        // 0..1
-    const float gainDb = gainParam->load();       // dB
-    const float outGain = juce::Decibels::decibelsToGain(gainDb);
-    const bool  useInterp = (*interpolateParam > 0.5f);
-    const float tap3Target = tap3Param->load();
-
-
-    timeMsSmoothed_s.setTargetValue(timeMsTarget_s);
-    timeMsSmoothed_f.setTargetValue(timeMsTarget_f);
-    tap3Smoothed.setTargetValue(tap3Target);
-
-    // ===== Per-sample / per-channel processing =====
-    // We process sample-by-sample so the delayLine write index advances
-    // once per sample (shared across all channels).
-    for (int i = 0; i < numSamples; ++i)
-    {
-        const float timeMsSmoothedNow_s = timeMsSmoothed_s.getNextValue();
-        const float timeMsSmoothedNow_f = timeMsSmoothed_f.getNextValue();
-        const float tap3MultNow = tap3Smoothed.getNextValue();
-
-
-        const float timeMsTap_s = timeMsSmoothedNow_s;
-        const float timeMsTap_f_1 = timeMsSmoothedNow_f;
-        // Second tap is 1.6x the first
-        const float timeMsTap_f_2 = timeMsSmoothedNow_f * 1.618f; // JuceDelayLine will clamp to its maxDelay internally
-        //const float timeMsTap_f_3 = timeMsSmoothedNow_f * 1.618f * 1.618f;
-        // user-controlled tap 3
-        const float timeMsTap_f_3 = timeMsSmoothedNow_f * tap3MultNow;
 
-        const bool delayOff_s = (timeMsSmoothedNow_s < 1.0f);
 
+//==============================================================================
+void MagicGUIAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    PluginState::write(apvts, destData);
+}
 
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
-        {
-            float* channelData = buffer.getWritePointer(channel);
-            const float drySample = channelData[i];
-            float out_s = 0.0f;
+void MagicGUIAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    if (!PluginState::read(apvts, data, sizeInBytes))
+        foleys::MagicProcessor::setStateInformation(data, sizeInBytes);
+}
 
-            //First delay line: short delay time
-            if (!delayOff_s)
-            {
-                const float d_s = delayLine_s.readSampleMs(channel, timeMsTap_s, true);
+//==============================================================================
+void MagicGUIAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+   #if JECHO_INSTRUMENTATION
+    loadMeter.prepare(sampleRate);
+   #endif
+
+    // The smoothed times start at the current values
+    updateEngineParameters();
+    engine.setParameters(engineParameters);
+    engine.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+}
 
-                // feedback inside delay1
-                float loopIn1 = drySample + applyFeedback(d_s, feedback_s);
-                loopIn1 = juce::jlimit(-1.0f, 1.0f, loopIn1); // safety clip
-                delayLine_s.writeSample(channel, loopIn1);
+void MagicGUIAudioProcessor::releaseResources()
+{
+    // Hibernate while the host has this instance stopped or disabled
+    engine.release();
+}
 
-                out_s = 0.8 * d_s; // output of first delay
-            }
-            else
-            {
-                out_s = drySample;
-            }
+void MagicGUIAudioProcessor::setNonRealtime (bool isNonRealtime) noexcept
+{
+    foleys::MagicProcessor::setNonRealtime (isNonRealtime);
+    engine.setNonRealtime (isNonRealtime);
+}
 
-            // Second delay line: two taps
-            // ---- Two taps from the delay line (in ms) ----
-            {
-                const float delayed_f_1 = delayLine_f.readSampleMs(channel, timeMsTap_f_1, useInterp); // integer delay
-                const float delayed_f_2 = delayLine_f.readSampleMs(channel, timeMsTap_f_2, useInterp); // integer delay
-                const float delayed_f_3 = delayLine_f.readSampleMs(channel, timeMsTap_f_3, useInterp); // integer delay
+void MagicGUIAudioProcessor::updateEngineParameters() noexcept
+{
+    auto& p = engineParameters;
+
+    p.timeMs_s = timeParam_s->load();
+    p.timeMs_f = timeParam_f->load();
+    p.tap3 = tap3Param->load();
+    p.feedback = feedbackParam->load();
+    p.mix = mixParam->load();
+    p.gainDb = gainParam->load();
+    p.bypassed = bypassParam->load() < 0.5f;
+    p.interpolate = interpolateParam->load() > 0.5f;
+    p.dampHighHz = dampHighParam->load();
+    p.dampLowHz = dampLowParam->load();
+    p.engine = juce::roundToInt(engineParam->load());
+    p.numTaps = juce::roundToInt(numTapsParam->load());
+
+    for (int t = 0; t < MultiTapTable::maxTaps; ++t)
+        p.taps[t] = { tapParams[t].time->load(), tapParams[t].gain->load(),
+                      tapParams[t].pan->load(), tapParams[t].send->load() };
+
+    p.grainSizeMs = grainSizeParam->load();
+    p.grainDensity = grainDensityParam->load();
+    p.grainRepeats = juce::roundToInt(grainRepeatParam->load());
+    p.crossFeed = juce::roundToInt(crossFeedParam->load());
+    p.crossWidth = crossWidthParam->load();
+    p.crossfadeTimes = timeModeParam->load() > 0.5f;
+    p.crossfadeMs = crossfadeMsParam->load();
+    p.loFi = juce::roundToInt(loFiParam->load());
+}
 
-                const float out_f = 0.35f * (delayed_f_1 + delayed_f_2 + delayed_f_3);
-                const float loopIn2 = out_s + applyFeedback(out_f, feedback_f);
+void MagicGUIAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
+    juce::MidiBuffer& midiMessages)
+{
+    JECHO_REALTIME_SCOPE
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-                // Write to the output of the delay line
-                float newDelaySample = juce::jlimit(-1.0f, 1.0f, loopIn2);
-                delayLine_f.writeSample(channel, newDelaySample);
+    const int numSamples = buffer.getNumSamples();
 
-                // Wet signal = average of both delayed taps + first delay line output
-                float wetSample = out_s;
-                if (delayOff_s)      // if short delay is off, don't double-count dry here
-                    wetSample = 0.0f;
-                wetSample += out_f;
+   #if JECHO_INSTRUMENTATION
+    ProcessLoadMeter::ScopedBlock timing(loadMeter, numSamples);
+   #endif
 
-                // ---- Mix block ----
-                float outSample = applyMix(drySample, wetSample, mix);
+   #if JECHO_TRACING
+    TraceBuffer::ScopedBlock traceBlock(traceBuffer.get(), numSamples);
+    if (traceBuffer != nullptr)
+        traceBuffer->recordParameterChanges();
+   #endif
 
-                // ---- Gain block ----
-                outSample = applyGain(outSample, outGain);
+    // Clear any extra output channels
+    for (auto ch = totalNumInputChannels; ch < totalNumOutputChannels; ++ch)
+        buffer.clear(ch, 0, numSamples);
 
-                channelData[i] = outSample;
-            }
-        }
+    updateEngineParameters();
+    engine.setParameters(engineParameters);
+    engine.process(buffer.getArrayOfWritePointers(), totalNumInputChannels, numSamples);
 
-        // After all channels for this sample: advance write index by 1
-        delayLine_s.advance();
-        delayLine_f.advance();
+   #if JECHO_TRACING
+    if (traceBuffer != nullptr)
+    {
+        traceBuffer->recordSwitch(TraceBuffer::bypass, engineParameters.bypassed);
+        traceBuffer->recordSwitch(TraceBuffer::idle, engine.isIdle());
     }
+   #endif
 }
 
 
@@ -9,12 +9,18 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "JuceDelayLine.h"
+#include "EchoEngine.h"
+#include "ProcessLoadMeter.h"
+#include "TraceRecorder.h"
+#include "GuiAssets.h"
+#include <optional>
 
 //==============================================================================
 /**
+    The plugin around EchoEngine: parameters, state, GUI and instrumentation.
 */
-class MagicGUIAudioProcessor  : public foleys::MagicProcessor
+class MagicGUIAudioProcessor  : public foleys::MagicProcessor,
+                                private juce::Timer
 {
 public:
     //==============================================================================
@@ -25,19 +31,38 @@ public:
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
 
+    // Offline bounces lay out the FDN's lines on the spot (EchoEngine::setNonRealtime)
+    void setNonRealtime (bool isNonRealtime) noexcept override;
+
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     juce::AudioProcessorValueTreeState::ParameterLayout
-        MagicGUIAudioProcessor::createParameterLayout();
+        createParameterLayout();
 
     //==============================================================================
     const juce::String getName() const override;
 
     double getTailLengthSeconds() const override;
 
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    void initialiseBuilder (foleys::MagicGUIBuilder& builder) override;
+    void editorBeingDeleted (juce::AudioProcessorEditor* editor) noexcept override;
+
+    //==============================================================================
+    // Binary state (PluginState); older XML states still load through MagicProcessor.
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
 
 
 private:
     //==============================================================================
+    // Copies the parameter values into engineParameters.
+    void updateEngineParameters() noexcept;
+
+    // Publishes the meters and the instrumentation to magicState while an editor is open.
+    void timerCallback() override;
+
     juce::AudioProcessorValueTreeState apvts;
 
     std::atomic<float>* timeParam_s = nullptr;
@@ -48,15 +73,51 @@ private:
     std::atomic<float>* bypassParam = nullptr; // bool params are exposed as float [0,1]
     std::atomic<float>* interpolateParam = nullptr;
     std::atomic<float>* tap3Param = nullptr;
+    std::atomic<float>* dampHighParam = nullptr;
+    std::atomic<float>* dampLowParam = nullptr;
+    std::atomic<float>* engineParam = nullptr;
+    std::atomic<float>* numTapsParam = nullptr;
+    std::atomic<float>* grainSizeParam = nullptr;
+    std::atomic<float>* grainDensityParam = nullptr;
+    std::atomic<float>* grainRepeatParam = nullptr;
+    std::atomic<float>* crossFeedParam = nullptr;
+    std::atomic<float>* crossWidthParam = nullptr;
+    std::atomic<float>* timeModeParam = nullptr;
+    std::atomic<float>* crossfadeMsParam = nullptr;
+    std::atomic<float>* loFiParam = nullptr;
+
+    struct TapParameters
+    {
+        std::atomic<float>* time = nullptr;
+        std::atomic<float>* gain = nullptr;
+        std::atomic<float>* pan = nullptr;
+        std::atomic<float>* send = nullptr;
+    };
+
+    TapParameters tapParams[MultiTapTable::maxTaps];
 
     //std::atomic<float>* timeParam = nullptr;
 
-    JuceDelayLine delayLine_s;
-    JuceDelayLine delayLine_f;
+    // The DSP, fed engineParameters once per block
+    EchoEngine engine;
+    EchoEngine::Parameters engineParameters;
+
+    int timerTicks = 0;
+
+   #if JECHO_INSTRUMENTATION
+    ProcessLoadMeter loadMeter;
+   #endif
+
+   #if JECHO_TRACING
+    // JECHO_TRACE=<file.json>: the audio-thread timeline. The buffer is null
+    // while tracing is off, so a block only pays for the null checks.
+    juce::SharedResourcePointer<TraceRecorder> traceRecorder;
+    std::unique_ptr<TraceBuffer> traceBuffer;
+   #endif
 
-    juce::LinearSmoothedValue<float> timeMsSmoothed_s;
-    juce::LinearSmoothedValue<float> timeMsSmoothed_f;
-    juce::LinearSmoothedValue<float> tap3Smoothed;
+    // GUI resources, loaded by the first createEditor rather than the constructor
+    bool guiTreeLoaded = false;
+    std::optional<juce::SharedResourcePointer<GuiAssets>> guiAssets;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MagicGUIAudioProcessor)
 };
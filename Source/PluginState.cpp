@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    PluginState.cpp
+    Created: 21 Mar 2026 3:26:54pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "PluginState.h"
+#include "MultiTapTable.h"
+
+namespace
+{
+    const char magic[] = { 'J', 'E', 'C', 'B' };
+    const int headerSize = (int)sizeof(magic) + 2;
+}
+
+// Append only: the position of an ID is its slot in every saved state.
+const juce::StringArray& PluginState::getParameterIDs()
+{
+    static const juce::StringArray ids = []
+    {
+        juce::StringArray list
+        {
+            "TIME_S", "TIME_F", "TAP3", "FEEDBACK", "MIX", "GAIN", "BYPASS", "INTERPOLATION",
+            "DAMP_HI", "DAMP_LO",   // version 2
+            "ENGINE"                // version 3
+        };
+
+        // version 4: the Multi Tap table
+        list.add("NUM_TAPS");
+
+        for (int t = 0; t < MultiTapTable::maxTaps; ++t)
+            for (auto* field : { "TIME", "GAIN", "PAN", "SEND" })
+                list.add(MultiTapTable::getParameterID(t, field));
+
+        list.addArray({ "GRAIN_SIZE", "GRAIN_DENSITY", "GRAIN_REPEAT" });   // version 5
+        list.addArray({ "XFEED", "XFEED_WIDTH" });                          // version 6
+        list.addArray({ "TIME_MODE", "XFADE_MS" });                         // version 7
+        list.add("LOFI");                                                   // version 8
+
+        return list;
+    }();
+
+    return ids;
+}
+
+bool PluginState::isBinaryState(const void* data, int sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= headerSize
+        && std::memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+void PluginState::write(const juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData)
+{
+    juce::MemoryOutputStream stream(destData, false);
+
+    stream.write(magic, sizeof(magic));
+    const auto& parameterIDs = getParameterIDs();
+    const int numParameterIDs = parameterIDs.size();
+    jassert(numParameterIDs <= 255);
+
+    stream.writeByte((char)formatVersion);
+    stream.writeByte((char)numParameterIDs);
+
+    for (int i = 0; i < numParameterIDs; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(parameterIDs[i]);
+        jassert(value != nullptr);
+        stream.writeFloat(value != nullptr ? value->load() : 0.0f);
+    }
+
+    // Whatever else hosts or the GUI keep in the state tree (rarely anything)
+    juce::ValueTree extra(apvts.state.getType());
+    for (const auto& child : apvts.state)
+        if (!child.hasType("PARAM"))
+            extra.appendChild(child.createCopy(), nullptr);
+
+    if (extra.getNumChildren() > 0)
+    {
+        juce::MemoryOutputStream extraStream;
+        extra.writeToStream(extraStream);
+
+        stream.writeInt((int)extraStream.getDataSize());
+        stream.write(extraStream.getData(), extraStream.getDataSize());
+    }
+    else
+    {
+        stream.writeInt(0);
+    }
+}
+
+bool PluginState::read(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes)
+{
+    if (!isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+    stream.skipNextBytes(sizeof(magic));
+    stream.readByte();  // version: only tells which IDs exist, numValues covers that
+
+    const int numValues = (int)(juce::uint8)stream.readByte();
+
+    // Cut short or corrupt: the missing values would read as 0, so apply none
+    if (stream.getNumBytesRemaining() < (juce::int64)numValues * (juce::int64)sizeof(float) + (juce::int64)sizeof(juce::int32))
+        return false;
+
+    const auto& parameterIDs = getParameterIDs();
+    const int numParameterIDs = parameterIDs.size();
+
+    for (int i = 0; i < juce::jmax(numValues, numParameterIDs); ++i)
+    {
+        auto* param = i < numParameterIDs ? apvts.getParameter(parameterIDs[i]) : nullptr;
+
+        if (i >= numValues)
+        {
+            // Saved before this parameter existed
+            if (param != nullptr)
+                param->setValueNotifyingHost(param->getDefaultValue());
+            continue;
+        }
+
+        const float value = stream.readFloat();
+
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+            ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+    }
+
+    const int extraSize = stream.readInt();
+
+    if (extraSize > 0 && extraSize <= stream.getNumBytesRemaining())
+    {
+        const auto extra = juce::ValueTree::readFromStream(stream);
+
+        for (const auto& child : extra)
+        {
+            apvts.state.removeChild(apvts.state.getChildWithName(child.getType()), nullptr);
+            apvts.state.appendChild(child.createCopy(), nullptr);
+        }
+    }
+
+    return true;
+}
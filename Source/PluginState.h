@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    PluginState.h
+    Created: 21 Mar 2026 3:26:54pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Compact binary plugin state, so sessions with hundreds of instances don't
+// spend their load time parsing XML.
+//
+// Layout, all little endian:
+//   "JECB"            magic
+//   uint8  version    formatVersion
+//   uint8  numValues  how many floats follow
+//   float  values[]   plain parameter values in getParameterIDs() order
+//   int32  extraSize  bytes of the rest (0 if none)
+//   ...               non-parameter children of the APVTS state, as a binary ValueTree
+//
+// New parameters are only ever appended to getParameterIDs() (and formatVersion
+// bumped), so every reader takes the values it knows and leaves the rest at
+// their defaults. Anything without the magic is an older state and is left
+// to foleys::MagicProcessor.
+class PluginState
+{
+public:
+    static constexpr juce::uint8 formatVersion = 8;
+
+    static void write (const juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData);
+
+    // False if the data isn't in this format or is too short for the values
+    // it announces (nothing is changed then).
+    static bool read (juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes);
+
+    static bool isBinaryState (const void* data, int sizeInBytes) noexcept;
+
+    // Every parameter in slot order; built once, the tap table IDs are generated.
+    // Append only: an ID's position is its slot in every saved state.
+    static const juce::StringArray& getParameterIDs();
+};
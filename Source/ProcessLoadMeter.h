@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    ProcessLoadMeter.h
+    Created: 19 Jan 2026 9:40:03pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Set JECHO_INSTRUMENTATION=0 to compile the per-block timing out entirely.
+#ifndef JECHO_INSTRUMENTATION
+ #define JECHO_INSTRUMENTATION 1
+#endif
+
+// Measures how much of each block's real-time budget processBlock used
+// (elapsed time / block duration) and collects it in a lock-free histogram.
+// The audio thread only records while someone is watching (setActive),
+// otherwise a block costs one relaxed atomic load.
+class ProcessLoadMeter
+{
+public:
+    static constexpr int   numBins = 256;
+    static constexpr float maxLoad = 2.0f; // loads above this land in the last bin
+
+    struct Stats
+    {
+        float p50 = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+        int   numBlocks = 0;
+    };
+
+    void prepare(double sampleRate) noexcept
+    {
+        jassert(sampleRate > 0);
+        ticksPerSample = (double)juce::Time::getHighResolutionTicksPerSecond() / sampleRate;
+    }
+
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive, std::memory_order_relaxed); }
+    bool isActive() const noexcept               { return active.load(std::memory_order_relaxed); }
+
+    // Times the scope it lives in, on the audio thread.
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(ProcessLoadMeter& m, int numSamplesInBlock) noexcept
+            : meter(m), numSamples(numSamplesInBlock),
+              startTicks(m.isActive() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedBlock() noexcept
+        {
+            if (startTicks != 0 && numSamples > 0)
+                meter.addBlock(juce::Time::getHighResolutionTicks() - startTicks, numSamples);
+        }
+
+    private:
+        ProcessLoadMeter& meter;
+        const int numSamples;
+        const juce::int64 startTicks;
+    };
+
+    // Audio thread. Single writer, so max only needs a load/store.
+    void addBlock(juce::int64 elapsedTicks, int numSamples) noexcept
+    {
+        const float load = (float)((double)elapsedTicks / (ticksPerSample * numSamples));
+        const int bin = juce::jlimit(0, numBins - 1, (int)(load * (numBins / maxLoad)));
+
+        bins[bin].fetch_add(1, std::memory_order_relaxed);
+
+        if (load > maxSeen.load(std::memory_order_relaxed))
+            maxSeen.store(load, std::memory_order_relaxed);
+    }
+
+    // Message thread: returns the statistics since the last call and starts a new window.
+    Stats collectStats() noexcept
+    {
+        Stats stats;
+        juce::uint32 counts[numBins];
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            counts[i] = bins[i].exchange(0, std::memory_order_relaxed);
+            stats.numBlocks += (int)counts[i];
+        }
+
+        stats.max = maxSeen.exchange(0.0f, std::memory_order_relaxed);
+
+        if (stats.numBlocks == 0)
+            return stats;
+
+        stats.p50 = percentile(counts, stats.numBlocks, 0.50f);
+        stats.p99 = juce::jmin(stats.max, percentile(counts, stats.numBlocks, 0.99f));
+        return stats;
+    }
+
+private:
+    // Upper edge of the bin that holds the requested fraction of blocks.
+    static float percentile(const juce::uint32* counts, int total, float fraction) noexcept
+    {
+        const auto wanted = (juce::uint32)std::ceil(fraction * (float)total);
+        juce::uint32 seen = 0;
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            seen += counts[i];
+            if (seen >= wanted)
+                return (float)(i + 1) * (maxLoad / numBins);
+        }
+
+        return maxLoad;
+    }
+
+    std::atomic<juce::uint32> bins[numBins] {};
+    std::atomic<float> maxSeen { 0.0f };
+    std::atomic<bool>  active { false };
+    double ticksPerSample = 1.0;
+};
@@ -0,0 +1,407 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.cpp
+    Created: 12 Jan 2026 10:12:41am
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafety.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if JECHO_REALTIME_CHECKS && defined (__GLIBC__)
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #define JECHO_INTERPOSE_LIBC 1
+#else
+ #define JECHO_INTERPOSE_LIBC 0
+#endif
+
+#if JECHO_REALTIME_CHECKS && defined (_WIN32)
+ #include <malloc.h>
+#endif
+
+namespace
+{
+    // initial-exec keeps the TLS access itself from calling malloc on first use
+   #if defined (__GNUC__) && ! defined (_WIN32)
+    __attribute__((tls_model("initial-exec")))
+   #endif
+    thread_local bool inAudioCallback = false;
+
+    std::atomic<int> violationCounts[RealtimeSafety::numViolationTypes] {};
+    std::atomic<bool> abortOnViolation { false };
+}
+
+//==============================================================================
+RealtimeSafety::ScopedAudioCallback::ScopedAudioCallback() noexcept
+    : wasInCallback(inAudioCallback)
+{
+    inAudioCallback = true;
+}
+
+RealtimeSafety::ScopedAudioCallback::~ScopedAudioCallback() noexcept
+{
+    inAudioCallback = wasInCallback;
+}
+
+bool RealtimeSafety::isInAudioCallback() noexcept
+{
+    return inAudioCallback;
+}
+
+void RealtimeSafety::noteCall(Violation type) noexcept
+{
+    if (!inAudioCallback)
+        return;
+
+    violationCounts[type].fetch_add(1, std::memory_order_relaxed);
+
+    if (abortOnViolation.load(std::memory_order_relaxed))
+        std::abort();
+}
+
+int RealtimeSafety::getViolationCount(Violation type) noexcept
+{
+    return violationCounts[type].load();
+}
+
+void RealtimeSafety::resetViolationCounts() noexcept
+{
+    for (auto& count : violationCounts)
+        count.store(0);
+}
+
+void RealtimeSafety::setAbortOnViolation(bool shouldAbort) noexcept
+{
+    abortOnViolation.store(shouldAbort);
+}
+
+//==============================================================================
+juce::String RealtimeSafety::Report::toString() const
+{
+    return juce::String(passed() ? "PASS" : "FAIL")
+        + ": " + juce::String(blocksProcessed) + " blocks, "
+        + juce::String(allocations) + " allocations, "
+        + juce::String(deallocations) + " deallocations, "
+        + juce::String(locks) + " mutex locks inside processBlock";
+}
+
+RealtimeSafety::Report RealtimeSafety::runChecks(juce::AudioProcessor& processor,
+    double sampleRate, int samplesPerBlock, int numPrepareCycles)
+{
+   #if ! JECHO_REALTIME_CHECKS
+    DBG("RealtimeSafety: built without JECHO_REALTIME_CHECKS, nothing will be recorded");
+   #endif
+
+    Report report;
+    juce::Random random(0x4543484f);
+
+    const int numChannels = juce::jmax(processor.getTotalNumInputChannels(),
+                                       processor.getTotalNumOutputChannels());
+
+    // Blocks up to twice the announced size also exercise the chunking path.
+    juce::AudioBuffer<float> buffer(numChannels, juce::jmax(samplesPerBlock * 2, maxHostBlockSize));
+    juce::MidiBuffer midi;
+
+    auto processSomeBlocks = [&](int numBlocks, int maxNumSamples)
+    {
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const int numSamples = 1 + random.nextInt(maxNumSamples);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = random.nextFloat() * 2.0f - 1.0f;
+            }
+
+            // Only the callback itself is measured; the harness runs outside it.
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+            processor.processBlock(block, midi);
+            ++report.blocksProcessed;
+        }
+    };
+
+    resetViolationCounts();
+
+    for (int cycle = 0; cycle < numPrepareCycles; ++cycle)
+    {
+        processor.setPlayConfigDetails(processor.getTotalNumInputChannels(),
+                                       processor.getTotalNumOutputChannels(),
+                                       sampleRate, samplesPerBlock);
+        processor.prepareToPlay(sampleRate, samplesPerBlock);
+        processSomeBlocks(8, samplesPerBlock * 2);
+
+        for (auto* param : processor.getParameters())
+        {
+            const float original = param->getValue();
+            const int numSteps = param->isBoolean() ? 4 : 16;
+
+            // Booleans (bypass, interpolation) toggle; everything else sweeps 0..1
+            for (int step = 0; step <= numSteps; ++step)
+            {
+                const float value = param->isBoolean() ? (float)(step & 1)
+                                                       : (float)step / (float)numSteps;
+                param->setValueNotifyingHost(value);
+                processSomeBlocks(2, samplesPerBlock * 2);
+            }
+
+            // Extreme jumps between the ends of the range
+            for (int jump = 0; jump < 4; ++jump)
+            {
+                param->setValueNotifyingHost(random.nextBool() ? 1.0f : 0.0f);
+                processSomeBlocks(1, samplesPerBlock * 2);
+            }
+
+            param->setValueNotifyingHost(original);
+        }
+
+        processor.releaseResources();
+    }
+
+    // Any host block size from 1 to maxHostBlockSize, prepared small and as
+    // large as that, with the short line switched off and on in between:
+    // blocks and chunks longer than a delay line must stay inside its ring.
+    juce::AudioProcessorParameter* shortTime = nullptr;
+
+    for (auto* param : processor.getParameters())
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
+            if (withID->paramID == "TIME_S")
+                shortTime = param;
+
+    for (auto preparedSize : { samplesPerBlock, maxHostBlockSize })
+    {
+        processor.setPlayConfigDetails(processor.getTotalNumInputChannels(),
+                                       processor.getTotalNumOutputChannels(),
+                                       sampleRate, preparedSize);
+        processor.prepareToPlay(sampleRate, preparedSize);
+
+        for (int step = 0; step < 16; ++step)
+        {
+            // Off (0 ms) for a few blocks, then on anywhere in its range
+            if (shortTime != nullptr)
+                shortTime->setValueNotifyingHost((step & 1) == 0 ? 0.0f : random.nextFloat());
+
+            processSomeBlocks(4, maxHostBlockSize);
+        }
+
+        processor.releaseResources();
+    }
+
+    report.allocations = getViolationCount(allocation);
+    report.deallocations = getViolationCount(deallocation);
+    report.locks = getViolationCount(lock);
+    return report;
+}
+
+//==============================================================================
+// Interposed entry points. These must never allocate or lock themselves.
+#if JECHO_REALTIME_CHECKS
+
+#if JECHO_INTERPOSE_LIBC
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void  __libc_free(void*);
+}
+
+namespace
+{
+    using LockFn = int (*)(pthread_mutex_t*);
+    std::atomic<LockFn> realMutexLock { nullptr };
+
+    LockFn resolveMutexLock() noexcept
+    {
+        auto fn = (LockFn)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        realMutexLock.store(fn, std::memory_order_release);
+        return fn;
+    }
+
+    // Resolved before main, so never for the first time inside a callback
+    __attribute__((constructor(101))) void resolveMutexLockEarly() { resolveMutexLock(); }
+}
+
+extern "C"
+{
+    void* malloc(size_t size) __THROW
+    {
+        RealtimeSafety::noteCall(RealtimeSafety::allocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t num, size_t size) __THROW
+    {
+        RealtimeSafety::noteCall(RealtimeSafety::allocation);
+        return __libc_calloc(num, size);
+    }
+
+    void* realloc(void* ptr, size_t size) __THROW
+    {
+        RealtimeSafety::noteCall(RealtimeSafety::allocation);
+        return __libc_realloc(ptr, size);
+    }
+
+    // The aligned entry points; libstdc++'s aligned operator new goes through these
+    void* memalign(size_t alignment, size_t size) __THROW
+    {
+        RealtimeSafety::noteCall(RealtimeSafety::allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) __THROW
+    {
+        RealtimeSafety::noteCall(RealtimeSafety::allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) __THROW
+    {
+        RealtimeSafety::noteCall(RealtimeSafety::allocation);
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        auto* ptr = __libc_memalign(alignment, size);
+        if (ptr == nullptr)
+            return ENOMEM;
+
+        *result = ptr;
+        return 0;
+    }
+
+    void free(void* ptr) __THROW
+    {
+        if (ptr != nullptr)
+            RealtimeSafety::noteCall(RealtimeSafety::deallocation);
+
+        __libc_free(ptr);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) __THROWNL
+    {
+        // Only a lock taken by another static initialiser can get here first
+        auto fn = realMutexLock.load(std::memory_order_acquire);
+        if (fn == nullptr)
+            fn = resolveMutexLock();
+
+        RealtimeSafety::noteCall(RealtimeSafety::lock);
+        return fn(mutex);
+    }
+}
+
+static void* rawAllocate(std::size_t size) noexcept { return __libc_malloc(size == 0 ? 1 : size); }
+static void  rawFree(void* ptr) noexcept            { __libc_free(ptr); }
+static void* rawAllocateAligned(std::size_t size, std::size_t alignment) noexcept { return __libc_memalign(alignment, size == 0 ? 1 : size); }
+static void  rawFreeAligned(void* ptr) noexcept     { __libc_free(ptr); }
+#elif defined (_WIN32)
+static void* rawAllocate(std::size_t size) noexcept { return std::malloc(size == 0 ? 1 : size); }
+static void  rawFree(void* ptr) noexcept            { std::free(ptr); }
+static void* rawAllocateAligned(std::size_t size, std::size_t alignment) noexcept { return _aligned_malloc(size == 0 ? 1 : size, alignment); }
+static void  rawFreeAligned(void* ptr) noexcept     { _aligned_free(ptr); }
+#else
+static void* rawAllocate(std::size_t size) noexcept { return std::malloc(size == 0 ? 1 : size); }
+static void  rawFree(void* ptr) noexcept            { std::free(ptr); }
+
+static void* rawAllocateAligned(std::size_t size, std::size_t alignment) noexcept
+{
+    void* ptr = nullptr;
+    return posix_memalign(&ptr, juce::jmax(alignment, sizeof(void*)), size == 0 ? 1 : size) == 0 ? ptr : nullptr;
+}
+
+static void  rawFreeAligned(void* ptr) noexcept     { std::free(ptr); }
+#endif
+
+void* operator new(std::size_t size)
+{
+    RealtimeSafety::noteCall(RealtimeSafety::allocation);
+
+    if (auto* ptr = rawAllocate(size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeSafety::noteCall(RealtimeSafety::allocation);
+    return rawAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeSafety::noteCall(RealtimeSafety::deallocation);
+
+    rawFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept                     { operator delete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept          { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept        { operator delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept   { operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+
+// Over-aligned types (alignas above the default new alignment)
+#if __cpp_aligned_new
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    RealtimeSafety::noteCall(RealtimeSafety::allocation);
+
+    if (auto* ptr = rawAllocateAligned(size, (std::size_t)alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    RealtimeSafety::noteCall(RealtimeSafety::allocation);
+    return rawAllocateAligned(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeSafety::noteCall(RealtimeSafety::deallocation);
+
+    rawFreeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept                 { operator delete(ptr, alignment); }
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept      { operator delete(ptr, alignment); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept    { operator delete(ptr, alignment); }
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept   { operator delete(ptr, alignment); }
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete(ptr, alignment); }
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.h
+    Created: 12 Jan 2026 10:12:41am
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Set JECHO_REALTIME_CHECKS=1 in a debug or test build to interpose
+// operator new/delete, plain and aligned (all platforms), and malloc/free,
+// memalign/aligned_alloc/posix_memalign and pthread_mutex_lock (glibc), and
+// record every call made while the current thread is inside processBlock.
+// Release builds leave it at 0, which compiles everything out.
+#ifndef JECHO_REALTIME_CHECKS
+ #define JECHO_REALTIME_CHECKS 0
+#endif
+
+class RealtimeSafety
+{
+public:
+    enum Violation
+    {
+        allocation = 0,
+        deallocation,
+        lock,
+        numViolationTypes
+    };
+
+    // Marks the current thread as being inside the audio callback.
+    class ScopedAudioCallback
+    {
+    public:
+        ScopedAudioCallback() noexcept;
+        ~ScopedAudioCallback() noexcept;
+
+    private:
+        bool wasInCallback;
+    };
+
+    static bool isInAudioCallback() noexcept;
+
+    // Called by the interposed functions. Never allocates or locks.
+    static void noteCall (Violation type) noexcept;
+
+    static int  getViolationCount (Violation type) noexcept;
+    static void resetViolationCounts() noexcept;
+
+    // Aborts on the first violation so a debugger stops right at the culprit.
+    static void setAbortOnViolation (bool shouldAbort) noexcept;
+
+    struct Report
+    {
+        int allocations = 0;
+        int deallocations = 0;
+        int locks = 0;
+        int blocksProcessed = 0;
+
+        bool passed() const noexcept { return allocations + deallocations + locks == 0; }
+        juce::String toString() const;
+    };
+
+    // The largest host block runChecks sends.
+    static constexpr int maxHostBlockSize = 16384;
+
+    // Drives the processor through prepareToPlay cycles, random block sizes,
+    // parameter sweeps and bypass toggles, and counts every violation seen
+    // inside processBlock. Parameters are changed outside the callback, the
+    // way a host would. A last pass sends blocks of 1 to maxHostBlockSize
+    // samples, prepared at samplesPerBlock and at maxHostBlockSize, while
+    // TIME_S switches the short line off and on (the jasserts of a Debug
+    // build catch a ring overrun there).
+    static Report runChecks (juce::AudioProcessor& processor,
+                             double sampleRate, int samplesPerBlock,
+                             int numPrepareCycles = 3);
+};
+
+#if JECHO_REALTIME_CHECKS
+ #define JECHO_REALTIME_SCOPE  RealtimeSafety::ScopedAudioCallback realtimeScope;
+#else
+ #define JECHO_REALTIME_SCOPE
+#endif
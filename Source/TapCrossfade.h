@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    TapCrossfade.h
+    Created: 23 Apr 2026 8:48:16pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// The Crossfade time mode of the three long-line taps: instead of gliding the
+// delay time (and the pitch with it), every tap keeps two integer read heads,
+// the old and the new time, and fades from one to the other over a fixed
+// window.
+//
+// A new time is only picked up once the fade before it has finished, so
+// automation turns into a series of clean fades rather than a pile of
+// overlapping ones. Between fades both heads are the same and a single
+// integer read per tap is enough.
+class TapCrossfade
+{
+public:
+    static constexpr int numTaps = 3;
+
+    // Takes effect with the next fade.
+    void setLength(int numSamples) noexcept { length = juce::jmax(1, numSamples); }
+
+    // Jumps straight to these delays (in samples), no fade.
+    void reset(const float* delays) noexcept
+    {
+        for (int t = 0; t < numTaps; ++t)
+            from[t] = to[t] = std::floor(delays[t]);
+
+        remaining = 0;
+    }
+
+    // One sample. heads holds the target delays on the way in and the old read
+    // heads on the way out, newHeads gets the new ones. Returns how far the
+    // fade is (the new head's gain, up to 1 on the last sample) or -1 while
+    // there is no fade.
+    float next(float* heads, float* newHeads) noexcept
+    {
+        if (remaining == 0)
+        {
+            bool changed = false;
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                to[t] = std::floor(heads[t]);
+                changed = changed || to[t] != from[t];
+            }
+
+            if (!changed)
+            {
+                for (int t = 0; t < numTaps; ++t)
+                    heads[t] = newHeads[t] = from[t];
+
+                return -1.0f;
+            }
+
+            fadeLength = length;
+            remaining = length;
+        }
+
+        const float position = (float)(fadeLength - remaining + 1) / (float)fadeLength;
+
+        for (int t = 0; t < numTaps; ++t)
+        {
+            heads[t] = from[t];
+            newHeads[t] = to[t];
+        }
+
+        if (--remaining == 0)
+            for (int t = 0; t < numTaps; ++t)
+                from[t] = to[t];
+
+        return position;
+    }
+
+private:
+    float from[numTaps] = {};
+    float to[numTaps] = {};
+    int length = 2048;
+    int fadeLength = 2048;
+    int remaining = 0;
+};
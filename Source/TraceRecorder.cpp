@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    TraceRecorder.cpp
+    Created: 26 Apr 2026 9:12:30pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#include "TraceRecorder.h"
+
+namespace
+{
+    const char* const switchNames[] = { "bypass", "idle" };
+    const int drainIntervalMs = 100;
+}
+
+//==============================================================================
+TraceBuffer::TraceBuffer(TraceRecorder& owner, int threadId)
+    : recorder(owner), tid(threadId)
+{
+}
+
+TraceBuffer::~TraceBuffer()
+{
+    recorder.remove(this);
+}
+
+void TraceBuffer::watchParameters(juce::AudioProcessorValueTreeState& apvts, const juce::StringArray& ids)
+{
+    parameterIDs.clear();
+    parameters.clear();
+    lastValues.clear();
+
+    for (const auto& id : ids)
+    {
+        if (auto* value = apvts.getRawParameterValue(id))
+        {
+            parameterIDs.add(id);
+            parameters.push_back(value);
+            lastValues.push_back(value->load());
+        }
+    }
+}
+
+void TraceBuffer::recordParameterChanges() noexcept
+{
+    for (size_t p = 0; p < parameters.size(); ++p)
+    {
+        const float value = parameters[p]->load(std::memory_order_relaxed);
+
+        if (value != lastValues[p])
+        {
+            lastValues[p] = value;
+            push(parameterChange, (int)p, value);
+        }
+    }
+}
+
+int TraceBuffer::pop(Event* destination, int maxEvents) noexcept
+{
+    const auto read = readPosition.load(std::memory_order_relaxed);
+    const auto available = writePosition.load(std::memory_order_acquire) - read;
+    const int count = (int)juce::jmin((juce::uint32)maxEvents, available);
+
+    for (int i = 0; i < count; ++i)
+        destination[i] = events[(read + (juce::uint32)i) & (capacity - 1)];
+
+    readPosition.store(read + (juce::uint32)count, std::memory_order_release);
+    return count;
+}
+
+//==============================================================================
+TraceRecorder::TraceRecorder()
+    : juce::Thread("JECHO trace")
+{
+    const auto path = juce::SystemStats::getEnvironmentVariable("JECHO_TRACE", {}).trim();
+
+    if (path.isEmpty())
+        return;
+
+    const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    file.deleteFile();
+    output = std::make_unique<juce::FileOutputStream>(file);
+
+    if (output->failedToOpen())
+    {
+        DBG("JECHO_TRACE: can't write " << file.getFullPathName());
+        output.reset();
+        return;
+    }
+
+    // The JSON array form of the format: one event object per line
+    *output << "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"JECHO\"}}";
+
+    drainScratch.allocate(TraceBuffer::capacity, false);
+    startTicks = juce::Time::getHighResolutionTicks();
+    startThread();
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    if (!isEnabled())
+        return;
+
+    stopThread(1000);
+
+    const juce::ScopedLock sl(lock);
+
+    for (auto* buffer : buffers)
+        drain(*buffer);
+
+    *output << "\n]\n";
+    output->flush();
+}
+
+std::unique_ptr<TraceBuffer> TraceRecorder::createBuffer()
+{
+    if (!isEnabled())
+        return {};
+
+    const juce::ScopedLock sl(lock);
+
+    std::unique_ptr<TraceBuffer> buffer(new TraceBuffer(*this, nextThreadId++));
+    buffers.add(buffer.get());
+
+    // Names the instance's track in the viewer
+    *output << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"JECHO #" << buffer->tid << "\"}}";
+
+    return buffer;
+}
+
+void TraceRecorder::remove(TraceBuffer* buffer)
+{
+    const juce::ScopedLock sl(lock);
+
+    drain(*buffer);
+    buffers.removeFirstMatchingValue(buffer);
+}
+
+void TraceRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(drainIntervalMs);
+
+        const juce::ScopedLock sl(lock);
+
+        for (auto* buffer : buffers)
+            drain(*buffer);
+
+        output->flush();
+    }
+}
+
+void TraceRecorder::drain(TraceBuffer& buffer)
+{
+    const double microsecondsPerTick = 1.0e6 / (double)juce::Time::getHighResolutionTicksPerSecond();
+    const auto tid = juce::String(buffer.tid);
+
+    auto toMicroseconds = [&](juce::int64 ticks) { return juce::String((double)ticks * microsecondsPerTick, 3); };
+
+    auto writeEvent = [&](const char* name, const char* phase, juce::int64 ticks, juce::int64 endTicks, const juce::String& args)
+    {
+        *output << ",\n{\"name\":\"" << name << "\",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid
+                << ",\"ts\":" << toMicroseconds(ticks - startTicks);
+
+        if (phase[0] == 'X')
+            *output << ",\"dur\":" << toMicroseconds(endTicks - ticks);
+        else
+            *output << ",\"s\":\"t\"";
+
+        if (args.isNotEmpty())
+            *output << ",\"args\":{" << args << "}";
+
+        *output << "}";
+    };
+
+    for (int count; (count = buffer.pop(drainScratch, TraceBuffer::capacity)) > 0;)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& event = drainScratch[i];
+
+            switch (event.type)
+            {
+                case TraceBuffer::block:
+                    writeEvent("processBlock", "X", event.ticks, event.endTicks,
+                               "\"samples\":" + juce::String(event.index));
+                    break;
+
+                case TraceBuffer::parameterChange:
+                    writeEvent(buffer.parameterIDs[event.index].toRawUTF8(), "i", event.ticks, event.ticks,
+                               "\"value\":" + juce::String(event.value));
+                    break;
+
+                case TraceBuffer::switchChange:
+                    writeEvent(switchNames[event.index], "i", event.ticks, event.ticks,
+                               "\"on\":" + juce::String(event.value > 0.5f ? 1 : 0));
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Overflow: how many events the audio thread couldn't store since the last drain
+    if (const auto lost = buffer.dropped.exchange(0, std::memory_order_relaxed))
+    {
+        const auto now = juce::Time::getHighResolutionTicks();
+        writeEvent("dropped", "i", now, now, "\"events\":" + juce::String((int)lost));
+    }
+}
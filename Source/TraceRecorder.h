@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    TraceRecorder.h
+    Created: 26 Apr 2026 9:12:30pm
+    Author:  Xie
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// Set JECHO_TRACING=0 to compile the audio-thread trace out entirely.
+#ifndef JECHO_TRACING
+ #define JECHO_TRACING 1
+#endif
+
+class TraceRecorder;
+
+// One instance's audio-thread events: processBlock calls (start, duration
+// and size), parameter changes, bypass and idle transitions. A fixed ring
+// with one writer (the audio thread) and one reader (TraceRecorder's
+// thread), so recording an event is a few stores and never blocks; when the
+// reader falls behind, events are dropped and counted instead.
+class TraceBuffer
+{
+public:
+    static constexpr int capacity = 8192;   // events, a power of two
+
+    enum Switch
+    {
+        bypass = 0,
+        idle,
+        numSwitches
+    };
+
+    ~TraceBuffer();
+
+    // Message thread, before processing: the parameters whose changes are
+    // recorded, by their index in ids.
+    void watchParameters(juce::AudioProcessorValueTreeState& apvts, const juce::StringArray& ids);
+
+    // Audio thread, once per block: an event for every watched parameter
+    // that moved since the last call.
+    void recordParameterChanges() noexcept;
+
+    // Audio thread: an event only when the state differs from the last one.
+    void recordSwitch(Switch which, bool on) noexcept
+    {
+        if (on != switchStates[which])
+        {
+            switchStates[which] = on;
+            push(switchChange, which, on ? 1.0f : 0.0f);
+        }
+    }
+
+    // Records the scope it lives in as one block event, start and end
+    // together, so a dropped event never leaves half a block behind. Does
+    // nothing for a null buffer (tracing off).
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(TraceBuffer* b, int numSamplesInBlock) noexcept
+            : buffer(b), numSamples(numSamplesInBlock),
+              startTicks(b != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedBlock() noexcept
+        {
+            if (buffer != nullptr)
+                buffer->push(block, numSamples, startTicks, juce::Time::getHighResolutionTicks());
+        }
+
+    private:
+        TraceBuffer* const buffer;
+        const int numSamples;
+        const juce::int64 startTicks;
+    };
+
+private:
+    friend class TraceRecorder;
+
+    enum EventType
+    {
+        block = 0,
+        parameterChange,
+        switchChange
+    };
+
+    struct Event
+    {
+        juce::int64 ticks;
+        juce::int64 endTicks;  // blocks only
+        int type;
+        int index;             // samples, parameter index or switch
+        float value;
+    };
+
+    TraceBuffer(TraceRecorder& owner, int threadId);
+
+    void push(int type, int index, float value) noexcept
+    {
+        const auto now = juce::Time::getHighResolutionTicks();
+        push({ now, now, type, index, value });
+    }
+
+    void push(int type, int numSamples, juce::int64 startTicks, juce::int64 endTicks) noexcept
+    {
+        push({ startTicks, endTicks, type, numSamples, 0.0f });
+    }
+
+    void push(const Event& event) noexcept
+    {
+        const auto write = writePosition.load(std::memory_order_relaxed);
+
+        if (write - readPosition.load(std::memory_order_acquire) >= (juce::uint32)capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        events[write & (capacity - 1)] = event;
+        writePosition.store(write + 1, std::memory_order_release);
+    }
+
+    // Reader side, TraceRecorder's thread.
+    int pop(Event* destination, int maxEvents) noexcept;
+
+    TraceRecorder& recorder;
+    const int tid;
+
+    Event events[capacity];
+    std::atomic<juce::uint32> writePosition { 0 };
+    std::atomic<juce::uint32> readPosition { 0 };
+    std::atomic<juce::uint32> dropped { 0 };
+
+    juce::StringArray parameterIDs;
+    std::vector<std::atomic<float>*> parameters;
+    std::vector<float> lastValues;
+    bool switchStates[numSwitches] = {};
+
+    JUCE_DECLARE_NON_COPYABLE (TraceBuffer)
+};
+
+// The process-wide side of the trace, shared by all instances through a
+// juce::SharedResourcePointer. With JECHO_TRACE=<file.json> in the
+// environment it opens that file and a background thread drains every
+// instance's TraceBuffer into it about ten times a second as Chrome Trace
+// Event JSON, which chrome://tracing and ui.perfetto.dev open directly (one
+// track per instance). Without it, createBuffer returns null and nothing is
+// recorded.
+class TraceRecorder : private juce::Thread
+{
+public:
+    TraceRecorder();
+    ~TraceRecorder() override;
+
+    bool isEnabled() const noexcept { return output != nullptr; }
+
+    // Message thread. Null while tracing is off.
+    std::unique_ptr<TraceBuffer> createBuffer();
+
+private:
+    friend class TraceBuffer;
+
+    void run() override;
+
+    // Under lock. Writes what buffer holds so far.
+    void drain(TraceBuffer& buffer);
+    void remove(TraceBuffer* buffer);
+
+    juce::CriticalSection lock;
+    std::unique_ptr<juce::FileOutputStream> output;
+    juce::Array<TraceBuffer*> buffers;
+    juce::HeapBlock<TraceBuffer::Event> drainScratch;
+    juce::int64 startTicks = 0;
+    int nextThreadId = 1;
+};